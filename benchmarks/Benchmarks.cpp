@@ -0,0 +1,494 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <list>
+#include <thread>
+#include "ArraySequence.hpp"
+#include "GapBufferSequence.hpp"
+#include "RopeSequence.hpp"
+#include "BTreeSequence.hpp"
+#include "SegmentedArraySequence.hpp"
+#include "Query.hpp"
+#include "LinkedList.hpp"
+#include "ListSequence.hpp"
+#include "Queue.hpp"
+#include "Deque.hpp"
+#include "PriorityQueue.hpp"
+
+// Замер времени выполнения body в миллисекундах
+template <typename Body>
+double Measure(Body body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+void Report(const char* name, long long operations, double milliseconds) {
+    std::printf("%-40s %10.2f ms %12.1f Mops/s\n",
+                name, milliseconds, operations / milliseconds / 1000.0);
+}
+
+// Стоимость одной операции на двух размерах (лучшая из трёх попыток):
+// у операций с O(1) на шаг отношение близко к 1, у линейных по длине
+// оно растёт вместе с large / small
+template <typename Body>
+void ReportScaling(const char* name, long long small, long long large, Body body) {
+    auto perOperation = [&](long long count) {
+        double best = 0;
+        for (int attempt = 0; attempt < 3; ++attempt) {
+            double time = Measure([&] { body(count); }) * 1e6 / count;
+            if (attempt == 0 || time < best) {
+                best = time;
+            }
+        }
+        return best;
+    };
+    double smallTime = perOperation(small);
+    double largeTime = perOperation(large);
+    std::printf("%-40s %8.2f ns/op at %lld, %8.2f ns/op at %lld, ratio %.2f\n",
+                name, smallTime, small, largeTime, large, largeTime / smallTime);
+}
+
+// Добавление в конец через хвостовой указатель не зависит от длины
+void BenchTailAppend() {
+    long long checksum = 0;
+    ReportScaling("Queue enqueue", 100000, 1000000, [&](long long count) {
+        Queue<int> queue;
+        for (long long i = 0; i < count; ++i) {
+            queue.Enqueue(static_cast<int>(i));
+        }
+        checksum += queue.GetSize();
+    });
+    ReportScaling("Deque push back", 100000, 1000000, [&](long long count) {
+        Deque<int> deque;
+        for (long long i = 0; i < count; ++i) {
+            deque.PushBack(static_cast<int>(i));
+        }
+        checksum += deque.PeekBack().getValue();
+    });
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Опустошение очередей: снятие элемента не зависит от длины, у
+// PriorityQueue - логарифм от неё
+void BenchDrain() {
+    long long checksum = 0;
+    ReportScaling("Queue fill + drain", 100000, 1000000, [&](long long count) {
+        Queue<int> queue;
+        for (long long i = 0; i < count; ++i) {
+            queue.Enqueue(static_cast<int>(i));
+        }
+        while (!queue.IsEmpty()) {
+            checksum += queue.Dequeue().getValue();
+        }
+    });
+    ReportScaling("Deque fill + drain from both ends", 100000, 1000000, [&](long long count) {
+        Deque<int> deque;
+        for (long long i = 0; i < count; ++i) {
+            deque.PushBack(static_cast<int>(i));
+        }
+        while (deque.PopBack().isSome() && deque.PopFront().isSome()) {
+        }
+        checksum += deque.GetSize();
+    });
+    ReportScaling("PriorityQueue ascending fill + drain", 100000, 1000000, [&](long long count) {
+        PriorityQueue<int> pq;
+        for (long long i = 0; i < count; ++i) {
+            pq.Enqueue(static_cast<int>(i), static_cast<int>(i));
+        }
+        while (!pq.IsEmpty()) {
+            checksum += pq.Dequeue().getValue();
+        }
+    });
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Очередь держится короткой, чтобы время определялось выделением узлов
+void BenchQueueThroughput() {
+    const int Rounds = 200000;
+    const int Depth = 8;
+    long long checksum = 0;
+    double time = Measure([&] {
+        Queue<int> queue;
+        for (int round = 0; round < Rounds; ++round) {
+            for (int i = 0; i < Depth; ++i) {
+                queue.Enqueue(i);
+            }
+            for (int i = 0; i < Depth; ++i) {
+                checksum += queue.Dequeue().getValue();
+            }
+        }
+    });
+    Report("Queue enqueue/dequeue", 2LL * Rounds * Depth, time);
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Построение и разрушение списка: LinkedList против std::list,
+// выделяющего каждый узел отдельно
+void BenchBuildAndClear() {
+    const int Rounds = 200;
+    const int Count = 100000;
+    long long checksum = 0;
+    double listTime = Measure([&] {
+        for (int round = 0; round < Rounds; ++round) {
+            LinkedList<int> list;
+            for (int i = 0; i < Count; ++i) {
+                list.Prepend(i);
+            }
+            checksum += list.GetFirst();
+        }
+    });
+    Report("LinkedList prepend + clear", 1LL * Rounds * Count, listTime);
+
+    double stdTime = Measure([&] {
+        for (int round = 0; round < Rounds; ++round) {
+            std::list<int> list;
+            for (int i = 0; i < Count; ++i) {
+                list.push_front(i);
+            }
+            checksum += list.front();
+        }
+    });
+    Report("std::list push_front + clear", 1LL * Rounds * Count, stdTime);
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Вставка в начало массива: каждый шаг сдвигает весь хвост
+void BenchArrayPrepend() {
+    const int Count = 50000;
+    long long checksum = 0;
+    double time = Measure([&] {
+        ArraySequence<int> sequence;
+        for (int i = 0; i < Count; ++i) {
+            sequence.Prepend(i);
+        }
+        checksum += sequence.GetFirst();
+    });
+    Report("ArraySequence<int> prepend", Count, time);
+    // при запасе спереди время одной вставки не растёт с размером
+    ReportScaling("ArraySequence<int> prepend", 100000, 1000000, [&](long long count) {
+        ArraySequence<int> sequence;
+        for (long long i = 0; i < count; ++i) {
+            sequence.Prepend(static_cast<int>(i));
+        }
+        checksum += sequence.GetFirst();
+    });
+    std::printf("  checksum %lld\n", checksum);
+}
+
+int Add(const int& left, const int& right) {
+    return left + right;
+}
+
+// Последовательный Get(i) по списку: палец держит последний узел, и
+// соседний индекс находится за шаг, а не обходом от ближнего конца
+void BenchSequentialGet() {
+    long long checksum = 0;
+    ReportScaling("Deque<int> sequential Get(i)", 20000, 200000, [&](long long count) {
+        Deque<int> deque;
+        for (long long i = 0; i < count; ++i) {
+            deque.PushBack(1);
+        }
+        for (long long i = 0; i < count; ++i) {
+            checksum += deque.Get(i);
+        }
+    });
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Reduce и перечисление идут по узлам, поэтому время на элемент не
+// растёт с длиной; при Get(i) от головы оно росло бы линейно
+void BenchListWalk() {
+    long long checksum = 0;
+    ReportScaling("ListSequence<int> reduce + enumerate", 100000, 1000000, [&](long long count) {
+        ListSequence<int> sequence;
+        for (long long i = 0; i < count; ++i) {
+            sequence.Append(1);
+        }
+        checksum += sequence.Reduce(Add, 0);
+        IEnumerator<int>* enumerator = sequence.GetEnumerator();
+        while (enumerator->MoveNext()) {
+            checksum += enumerator->Current();
+        }
+        delete enumerator;
+    });
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Свёртка списка: проход по узлам, а не Get(i) от головы на каждом шаге
+template <template <typename, typename> class List>
+void BenchListReduce(const char* name) {
+    const int Count = 1000000;
+    ListSequence<int, std::allocator<int>, List> sequence;
+    for (int i = 0; i < Count; ++i) {
+        sequence.Append(i % 7);
+    }
+    long long checksum = 0;
+    double time = Measure([&] {
+        checksum += sequence.Reduce(Add, 0);
+    });
+    Report(name, Count, time);
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Свёртка массива: указатель на функцию через Sequence<int>* против лямбды,
+// которую шаблонная перегрузка встраивает в цикл
+void BenchArrayReduce() {
+    const int Count = 10000000;
+    const int Rounds = 10;
+    ArraySequence<int> sequence;
+    for (int i = 0; i < Count; ++i) {
+        sequence.Append(i % 7);
+    }
+    const Sequence<int>* base = &sequence;
+    long long checksum = 0;
+    double time = Measure([&] {
+        for (int round = 0; round < Rounds; ++round) {
+            checksum += base->Reduce(Add, 0);
+        }
+    });
+    Report("ArraySequence<int> reduce, function ptr", static_cast<long long>(Count) * Rounds, time);
+    time = Measure([&] {
+        for (int round = 0; round < Rounds; ++round) {
+            checksum += sequence.Reduce([](const int& left, const int& right) { return left + right; }, 0);
+        }
+    });
+    Report("ArraySequence<int> reduce, lambda", static_cast<long long>(Count) * Rounds, time);
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Проекция в другой тип: ручной цикл с Append против Map<R> с одним выделением
+template <template <typename, typename> class List>
+void BenchTypedMap(const char* name) {
+    const int Count = 2000000;
+    ListSequence<int, std::allocator<int>, List> sequence;
+    for (int i = 0; i < Count; ++i) {
+        sequence.Append(i);
+    }
+    long long checksum = 0;
+    double manual = 0;
+    double mapped = 0;
+    for (int round = 0; round < 3; ++round) {
+    manual += Measure([&] {
+        ListSequence<long long, std::allocator<long long>, List> result;
+        for (auto cursor = sequence.First(); cursor.IsValid(); cursor.MoveNext()) {
+            result.Append(3LL * cursor.Get());
+        }
+        checksum += result.GetLast();
+    });
+    mapped += Measure([&] {
+        Sequence<long long>* result = sequence.Map([](const int& x) { return 3LL * x; });
+        checksum += result->GetLast();
+        delete result;
+    });
+    }
+    std::printf("%-40s manual %.2f ms, Map<R> %.2f ms, checksum %lld\n", name, manual, mapped, checksum);
+}
+
+// Where -> Map -> Reduce: жадная цепочка строит две промежуточные
+// последовательности, ленивый запрос проходит источник один раз
+void BenchQueryPipeline() {
+    const int Count = 10000000;
+    const int Rounds = 5;
+    ArraySequence<int> sequence;
+    for (int i = 0; i < Count; ++i) {
+        sequence.Append(i % 1000);
+    }
+    auto even = [](const int& x) { return x % 2 == 0; };
+    auto triple = [](const int& x) { return x * 3; };
+    auto add = [](const int& left, const int& right) { return left + right; };
+    long long checksum = 0;
+    double time = Measure([&] {
+        for (int round = 0; round < Rounds; ++round) {
+            auto* filtered = static_cast<ArraySequence<int>*>(sequence.Where(even));
+            auto* mapped = static_cast<ArraySequence<int>*>(filtered->Map(triple));
+            checksum += mapped->Reduce(add, 0);
+            delete filtered;
+            delete mapped;
+        }
+    });
+    Report("ArraySequence<int> eager Where/Map/Reduce", static_cast<long long>(Count) * Rounds, time);
+    time = Measure([&] {
+        for (int round = 0; round < Rounds; ++round) {
+            checksum += From(sequence).Where(even).Map(triple).Reduce(add, 0);
+        }
+    });
+    Report("ArraySequence<int> lazy Where/Map/Reduce", static_cast<long long>(Count) * Rounds, time);
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Последовательные HOF против параллельных на большом массиве. Отношение
+// времён зависит от числа ядер (печатается в конце); на одном ядре оно
+// показывает только накладные расходы разбиения на куски
+void BenchParallelHof() {
+    const int Count = 50000000;
+    ArraySequence<int> sequence;
+    for (int i = 0; i < Count; ++i) {
+        sequence.Append(i % 1000);
+    }
+    auto add = [](const long long& left, const long long& right) { return left + right; };
+    auto heavy = [](const int& x) { return std::sqrt(double(x)) * 1.5 + x; };
+    auto even = [](const int& x) { return x % 2 == 0; };
+    auto last = [](const int& x) { return x > 998; };
+    ArraySequence<long long> wide;
+    wide.Reserve(Count);
+    for (int i = 0; i < Count; ++i) {
+        wide.Append(i % 1000);
+    }
+    double checksum = 0;
+    double sequential = Measure([&] { checksum += wide.Reduce(add, 0LL); });
+    double parallel = Measure([&] { checksum += wide.ParallelReduce(add, 0LL); });
+    std::printf("%-40s sequential %8.2f ms, parallel %8.2f ms, ratio %.2f\n", "reduce 50M", sequential, parallel, sequential / parallel);
+    sequential = Measure([&] {
+        Sequence<double>* result = sequence.Map(heavy);
+        checksum += result->GetLast();
+        delete result;
+    });
+    parallel = Measure([&] {
+        Sequence<double>* result = sequence.ParallelMap(heavy);
+        checksum += result->GetLast();
+        delete result;
+    });
+    std::printf("%-40s sequential %8.2f ms, parallel %8.2f ms, ratio %.2f\n", "map sqrt 50M", sequential, parallel, sequential / parallel);
+    sequential = Measure([&] {
+        Sequence<int>* result = sequence.Where(even);
+        checksum += result->GetLength();
+        delete result;
+    });
+    parallel = Measure([&] {
+        Sequence<int>* result = sequence.ParallelWhere(even);
+        checksum += result->GetLength();
+        delete result;
+    });
+    std::printf("%-40s sequential %8.2f ms, parallel %8.2f ms, ratio %.2f\n", "where even 50M", sequential, parallel, sequential / parallel);
+    sequence.Append(5000);
+    auto missing = [](const int& x) { return x > 1000; };
+    sequential = Measure([&] { checksum += sequence.Find(missing).getValue(); });
+    parallel = Measure([&] { checksum += sequence.ParallelFind(missing).getValue(); });
+    std::printf("%-40s sequential %8.2f ms, parallel %8.2f ms, ratio %.2f\n", "find at the end 50M", sequential, parallel, sequential / parallel);
+    parallel = Measure([&] { checksum += sequence.ParallelFind(last).getValue(); });
+    std::printf("%-40s %8.2f ms parallel (early cancellation)\n", "find near the start 50M", parallel);
+    std::printf("  threads %u, checksum %.0f\n", std::thread::hardware_concurrency(), checksum);
+}
+
+// Правки вокруг курсора в середине длинной последовательности
+template <typename SequenceType>
+void BenchCursorEdits(const char* name) {
+    const int Count = 200000;
+    const int Edits = 100000;
+    SequenceType sequence;
+    for (int i = 0; i < Count; ++i) {
+        sequence.Append(i);
+    }
+    IndexType cursor = Count / 2;
+    double time = Measure([&] {
+        for (int i = 0; i < Edits; ++i) {
+            sequence.InsertAt(i, cursor);
+            cursor += (i % 3 == 0) ? 1 : 0;
+        }
+    });
+    Report(name, Edits, time);
+    std::printf("  checksum %d\n", sequence.Get(Count / 2));
+}
+
+// Concat + GetSubsequence большой последовательности: копирование против разделения узлов
+template <typename SequenceType>
+void BenchConcatSlice(const char* name) {
+    const int Count = 4000000;
+    const int Rounds = 10;
+    DynamicArray<int> values;
+    for (int i = 0; i < Count; ++i) {
+        values.PushBack(i);
+    }
+    SequenceType sequence(values.Data(), Count);
+    long long checksum = 0;
+    double time = Measure([&] {
+        for (int round = 0; round < Rounds; ++round) {
+            Sequence<int>* joined = sequence.Concat(&sequence);
+            Sequence<int>* middle = joined->GetSubsequence(Count / 2, Count + Count / 2);
+            checksum += middle->Get(round);
+            delete middle;
+            delete joined;
+        }
+    });
+    Report(name, Rounds, time);
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Вставки и чтения по случайным индексам в уже большой последовательности
+template <typename SequenceType>
+void BenchRandomIndexed(const char* name) {
+    const int Count = 1000000;
+    const int Operations = 100000;
+    DynamicArray<int> values;
+    for (int i = 0; i < Count; ++i) {
+        values.PushBack(i);
+    }
+    SequenceType sequence(values.Data(), Count);
+    long long checksum = 0;
+    unsigned state = 1;
+    double time = Measure([&] {
+        for (int i = 0; i < Operations; ++i) {
+            state = state * 1103515245u + 12345u;
+            IndexType index = static_cast<IndexType>((state >> 4) % sequence.GetLength());
+            if (i % 2 == 0) {
+                sequence.InsertAt(i, index);
+            } else {
+                checksum += sequence.Get(index);
+            }
+        }
+    });
+    Report(name, Operations, time);
+    std::printf("  checksum %lld\n", checksum);
+}
+
+// Рост большой последовательности: общее время и самое долгое одиночное добавление
+template <typename SequenceType>
+void BenchAppendStall(const char* name) {
+    const int Count = 50000000;
+    double worst = 0;
+    long long checksum = 0;
+    double time = Measure([&] {
+        SequenceType sequence;
+        for (int i = 0; i < Count; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            sequence.Append(i);
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            worst = elapsed > worst ? elapsed : worst;
+        }
+        checksum += sequence.GetLast();
+    });
+    Report(name, Count, time);
+    std::printf("  worst append %.2f ms, checksum %lld\n", worst, checksum);
+}
+
+int main() {
+    BenchQueueThroughput();
+    BenchTailAppend();
+    BenchDrain();
+    BenchBuildAndClear();
+    BenchArrayPrepend();
+    BenchListReduce<LinkedList>("ListSequence<int> reduce");
+    BenchListReduce<UnrolledLinkedList>("ListSequence<int> reduce, unrolled");
+    BenchListWalk();
+    BenchSequentialGet();
+    BenchArrayReduce();
+    BenchTypedMap<LinkedList>("ListSequence<int> -> long long");
+    BenchTypedMap<UnrolledLinkedList>("unrolled ListSequence<int> -> long long");
+    BenchQueryPipeline();
+    BenchParallelHof();
+    BenchCursorEdits<ArraySequence<int>>("ArraySequence<int> edits at cursor");
+    BenchCursorEdits<GapBufferSequence<int>>("GapBufferSequence<int> edits at cursor");
+    BenchConcatSlice<ArraySequence<int>>("ArraySequence<int> concat + slice");
+    BenchConcatSlice<RopeSequence<int>>("RopeSequence<int> concat + slice");
+    BenchRandomIndexed<ArraySequence<int>>("ArraySequence<int> random insert/get");
+    BenchRandomIndexed<RopeSequence<int>>("RopeSequence<int> random insert/get");
+    BenchRandomIndexed<BTreeSequence<int>>("BTreeSequence<int> random insert/get");
+    BenchAppendStall<ArraySequence<int>>("ArraySequence<int> append 50M");
+    BenchAppendStall<SegmentedArraySequence<int>>("SegmentedArraySequence<int> append 50M");
+    std::printf("bytes per int: list node %zu, unrolled node %.2f\n", sizeof(Node<int>),
+                double(sizeof(UnrolledNode<int, UnrolledLinkedList<int>::NodeCapacity>))
+                    / UnrolledLinkedList<int>::NodeCapacity);
+    return 0;
+}
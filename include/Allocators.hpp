@@ -0,0 +1,319 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include "Exceptions.hpp"
+
+// Монотонная арена: выделение - сдвиг указателя внутри текущего блока,
+// освобождение отдельных объектов ничего не делает, Release() отдаёт всё сразу
+class MonotonicArena {
+private:
+    struct Block {
+        Block* next;
+        std::size_t size;
+    };
+
+    Block* blocks;
+    unsigned char* initialBuffer;
+    std::size_t initialSize;
+    unsigned char* current;
+    unsigned char* end;
+    std::size_t nextBlockSize;
+
+    static std::size_t AlignUp(std::size_t value, std::size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void AddBlock(std::size_t minBytes) {
+        std::size_t header = AlignUp(sizeof(Block), alignof(std::max_align_t));
+        std::size_t size = nextBlockSize;
+        while (size < minBytes + header) {
+            size *= 2;
+        }
+        Block* block = static_cast<Block*>(::operator new(size));
+        block->next = blocks;
+        block->size = size;
+        blocks = block;
+        current = reinterpret_cast<unsigned char*>(block) + header;
+        end = reinterpret_cast<unsigned char*>(block) + size;
+        nextBlockSize = size * 2;
+    }
+
+public:
+    static const std::size_t DefaultBlockSize = 64 * 1024;
+
+    explicit MonotonicArena(std::size_t blockSize = DefaultBlockSize)
+        : blocks(nullptr), initialBuffer(nullptr), initialSize(0),
+          current(nullptr), end(nullptr), nextBlockSize(blockSize) {
+        if (blockSize == 0) {
+            throw InvalidSizeException("Arena block size must be positive");
+        }
+    }
+
+    // Начальный буфер принадлежит вызывающему; пока он не исчерпан,
+    // арена вообще не обращается к системному аллокатору
+    MonotonicArena(void* buffer, std::size_t size, std::size_t blockSize = DefaultBlockSize)
+        : blocks(nullptr), initialBuffer(static_cast<unsigned char*>(buffer)), initialSize(size),
+          current(static_cast<unsigned char*>(buffer)), end(static_cast<unsigned char*>(buffer) + size),
+          nextBlockSize(blockSize) {
+        if (blockSize == 0) {
+            throw InvalidSizeException("Arena block size must be positive");
+        }
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() {
+        Release();
+    }
+
+    void* Allocate(std::size_t bytes, std::size_t alignment) {
+        std::size_t address = reinterpret_cast<std::size_t>(current);
+        std::size_t padding = AlignUp(address, alignment) - address;
+        if (current == nullptr || padding + bytes > static_cast<std::size_t>(end - current)) {
+            AddBlock(bytes + alignment);
+            address = reinterpret_cast<std::size_t>(current);
+            padding = AlignUp(address, alignment) - address;
+        }
+        void* result = current + padding;
+        current += padding + bytes;
+        return result;
+    }
+
+    // Освобождает все выделенные блоки разом; деструкторы объектов не вызываются
+    void Release() {
+        while (blocks) {
+            Block* next = blocks->next;
+            ::operator delete(blocks);
+            blocks = next;
+        }
+        current = initialBuffer;
+        end = initialBuffer ? initialBuffer + initialSize : nullptr;
+    }
+};
+
+template <typename T>
+class ArenaAllocator {
+private:
+    MonotonicArena* arena;
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit ArenaAllocator(MonotonicArena& arena) noexcept : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(arena->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) noexcept {}
+
+    MonotonicArena* GetArena() const {
+        return arena;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return arena != other.arena;
+    }
+};
+
+// Пул блоков одного размера: блоки нарезаются из крупных кусков памяти,
+// освобождённые блоки попадают в список свободных и переиспользуются
+class FixedSizePool {
+private:
+    struct FreeChunk {
+        FreeChunk* next;
+    };
+
+    struct Slab {
+        Slab* next;
+    };
+
+    std::size_t chunkSize;
+    std::size_t chunksPerSlab;
+    FreeChunk* freeList;
+    Slab* slabs;
+
+    static const std::size_t SlabHeader = alignof(std::max_align_t) > sizeof(Slab)
+        ? alignof(std::max_align_t) : sizeof(Slab);
+
+    void AddSlab() {
+        unsigned char* memory = static_cast<unsigned char*>(
+            ::operator new(SlabHeader + chunkSize * chunksPerSlab));
+        Slab* slab = reinterpret_cast<Slab*>(memory);
+        slab->next = slabs;
+        slabs = slab;
+        unsigned char* first = memory + SlabHeader;
+        for (std::size_t i = chunksPerSlab; i > 0; --i) {
+            FreeChunk* chunk = reinterpret_cast<FreeChunk*>(first + (i - 1) * chunkSize);
+            chunk->next = freeList;
+            freeList = chunk;
+        }
+    }
+
+public:
+    static const std::size_t DefaultChunksPerSlab = 256;
+
+    explicit FixedSizePool(std::size_t chunkSize, std::size_t chunksPerSlab = DefaultChunksPerSlab)
+        : chunkSize(chunkSize < sizeof(FreeChunk) ? sizeof(FreeChunk) : chunkSize),
+          chunksPerSlab(chunksPerSlab), freeList(nullptr), slabs(nullptr) {
+        if (chunkSize == 0 || chunksPerSlab == 0) {
+            throw InvalidSizeException("Pool chunk size and slab length must be positive");
+        }
+        std::size_t alignment = alignof(std::max_align_t);
+        this->chunkSize = (this->chunkSize + alignment - 1) & ~(alignment - 1);
+    }
+
+    FixedSizePool(const FixedSizePool&) = delete;
+    FixedSizePool& operator=(const FixedSizePool&) = delete;
+
+    ~FixedSizePool() {
+        Release();
+    }
+
+    std::size_t GetChunkSize() const {
+        return chunkSize;
+    }
+
+    void* Allocate() {
+        if (!freeList) {
+            AddSlab();
+        }
+        FreeChunk* chunk = freeList;
+        freeList = chunk->next;
+        return chunk;
+    }
+
+    void Deallocate(void* pointer) noexcept {
+        FreeChunk* chunk = static_cast<FreeChunk*>(pointer);
+        chunk->next = freeList;
+        freeList = chunk;
+    }
+
+    void Release() {
+        while (slabs) {
+            Slab* next = slabs->next;
+            ::operator delete(slabs);
+            slabs = next;
+        }
+        freeList = nullptr;
+    }
+};
+
+// Набор пулов по классам размеров; запросы крупнее MaxPooledSize и
+// с повышенным выравниванием уходят в системный аллокатор
+class PoolResource {
+private:
+    static const std::size_t Granularity = alignof(std::max_align_t);
+    static const std::size_t ClassCount = 16;
+
+    FixedSizePool* pools[ClassCount];
+    std::size_t chunksPerSlab;
+
+    static bool IsPooled(std::size_t bytes, std::size_t alignment) {
+        return bytes <= MaxPooledSize && alignment <= Granularity;
+    }
+
+    FixedSizePool& PoolFor(std::size_t bytes) {
+        std::size_t index = bytes == 0 ? 0 : (bytes - 1) / Granularity;
+        if (!pools[index]) {
+            pools[index] = new FixedSizePool((index + 1) * Granularity, chunksPerSlab);
+        }
+        return *pools[index];
+    }
+
+public:
+    static const std::size_t MaxPooledSize = Granularity * ClassCount;
+
+    explicit PoolResource(std::size_t chunksPerSlab = FixedSizePool::DefaultChunksPerSlab)
+        : pools(), chunksPerSlab(chunksPerSlab) {}
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource() {
+        for (std::size_t i = 0; i < ClassCount; ++i) {
+            delete pools[i];
+        }
+    }
+
+    void* Allocate(std::size_t bytes, std::size_t alignment) {
+        if (!IsPooled(bytes, alignment)) {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+        return PoolFor(bytes).Allocate();
+    }
+
+    void Deallocate(void* pointer, std::size_t bytes, std::size_t alignment) noexcept {
+        if (!IsPooled(bytes, alignment)) {
+            ::operator delete(pointer, std::align_val_t(alignment));
+            return;
+        }
+        PoolFor(bytes).Deallocate(pointer);
+    }
+
+    // Возвращает память всех пулов; объекты внутри должны быть уже разрушены
+    void Release() {
+        for (std::size_t i = 0; i < ClassCount; ++i) {
+            if (pools[i]) {
+                pools[i]->Release();
+            }
+        }
+    }
+};
+
+template <typename T>
+class PoolAllocator {
+private:
+    PoolResource* resource;
+
+    template <typename U>
+    friend class PoolAllocator;
+
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit PoolAllocator(PoolResource& resource) noexcept : resource(&resource) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : resource(other.resource) {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(resource->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        resource->Deallocate(pointer, count * sizeof(T), alignof(T));
+    }
+
+    PoolResource* GetResource() const {
+        return resource;
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const {
+        return resource == other.resource;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const {
+        return resource != other.resource;
+    }
+};
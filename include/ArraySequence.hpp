@@ -1,29 +1,29 @@
 #pragma once
+#include <type_traits>
 #include <utility>
-#include "Sequence.hpp"
+#include "SequenceOps.hpp"
 #include "DynamicArray.hpp"
+#include "Parallel.hpp"
 #include "Exceptions.hpp"
 
-template <typename T>
-class ArraySequence : public Sequence<T> {
+template <typename T, typename Allocator = std::allocator<T>, int InlineCapacity = 0>
+class ArraySequence : public SequenceOps<T, ArraySequence<T, Allocator, InlineCapacity>> {
 protected:
-    DynamicArray<T> array;
+    DynamicArray<T, Allocator, InlineCapacity> array;
 
 private:
     class ArraySequenceEnumerator : public IEnumerator<T> {
     private:
-        const DynamicArray<T>& array;
-        int currentIndex;
-        T currentValue;
+        const DynamicArray<T, Allocator, InlineCapacity>& array;
+        IndexType currentIndex;
 
     public:
-        explicit ArraySequenceEnumerator(const DynamicArray<T>& array) 
+        explicit ArraySequenceEnumerator(const DynamicArray<T, Allocator, InlineCapacity>& array) 
             : array(array), currentIndex(-1) {}
 
         bool MoveNext() override {
             if (currentIndex + 1 < array.GetSize()) {
                 currentIndex++;
-                currentValue = array.Get(currentIndex);
                 return true;
             }
             return false;
@@ -33,7 +33,7 @@ private:
             if (currentIndex < 0 || currentIndex >= array.GetSize()) {
                 throw InvalidStateException("Enumerator is not in a valid position");
             }
-            return currentValue;
+            return array[currentIndex];
         }
 
         void Reset() override {
@@ -43,132 +43,209 @@ private:
 
 public:
     ArraySequence() = default;
-    ArraySequence(T* items, int count) : array(items, count) {}
-    ArraySequence(const T* items, int count) {
-        T* nonConstItems = new T[count];
-        for (int i = 0; i < count; ++i) {
-            nonConstItems[i] = items[i];
-        }
-        array = DynamicArray<T>(nonConstItems, count);
-        delete[] nonConstItems;
-    }
-    ArraySequence(const DynamicArray<T>& other) : array(other) {}
+    explicit ArraySequence(const Allocator& allocator) : array(allocator) {}
+    ArraySequence(T* items, IndexType count, const Allocator& allocator = Allocator())
+        : array(items, count, allocator) {}
+    ArraySequence(const T* items, IndexType count, const Allocator& allocator = Allocator())
+        : array(items, count, allocator) {}
+    ArraySequence(const DynamicArray<T, Allocator, InlineCapacity>& other) : array(other) {}
+    ArraySequence(DynamicArray<T, Allocator, InlineCapacity>&& other) : array(std::move(other)) {}
     // from
-    ArraySequence(const ArraySequence<T>& other) : array(other.array) {}
+    ArraySequence(const ArraySequence<T, Allocator, InlineCapacity>& other) : array(other.array) {}
+    ArraySequence(ArraySequence<T, Allocator, InlineCapacity>&& other)
+        noexcept(std::is_nothrow_move_constructible<DynamicArray<T, Allocator, InlineCapacity>>::value)
+        : array(std::move(other.array)) {}
+
+    ArraySequence& operator=(const ArraySequence<T, Allocator, InlineCapacity>& other) {
+        array = other.array;
+        return *this;
+    }
 
-    T Get(int index) const override {
+    ArraySequence& operator=(ArraySequence<T, Allocator, InlineCapacity>&& other)
+        noexcept(std::is_nothrow_move_assignable<DynamicArray<T, Allocator, InlineCapacity>>::value) {
+        array = std::move(other.array);
+        return *this;
+    }
+
+    T Get(IndexType index) const override {
         return array.Get(index);
     }
 
     T GetFirst() const override {
+        return FirstRef();
+    }
+
+    T GetLast() const override {
+        return LastRef();
+    }
+
+    const T& At(IndexType index) const override {
+        return array[index];
+    }
+
+    // Непрерывный буфер элементов; действителен до следующего изменения
+    const T* Data() const {
+        return array.Data();
+    }
+
+    const T& FirstRef() const override {
         if (array.GetSize() == 0) {
             throw EmptySequenceException();
         }
-        return array.Get(0);
+        return array.Data()[0];
     }
 
-    T GetLast() const override {
+    const T& LastRef() const override {
         if (array.GetSize() == 0) {
             throw EmptySequenceException();
         }
-        return array.Get(array.GetSize() - 1);
+        return array.Data()[array.GetSize() - 1];
     }
 
-    Option<T> TryGet(int index) const override {
+    Option<T> TryGet(IndexType index) const override {
         if (index < 0 || index >= array.GetSize()) {
             return Option<T>::None();
         }
-        return Option<T>::Some(array.Get(index));
+        return Option<T>::Some(array.Data()[index]);
     }
 
     Option<T> TryGetFirst() const override {
         if (array.GetSize() == 0) {
             return Option<T>::None();
         }
-        return Option<T>::Some(array.Get(0));
+        return Option<T>::Some(array.Data()[0]);
     }
 
     Option<T> TryGetLast() const override {
         if (array.GetSize() == 0) {
             return Option<T>::None();
         }
-        return Option<T>::Some(array.Get(array.GetSize() - 1));
+        return Option<T>::Some(array.Data()[array.GetSize() - 1]);
     }
 
-    Sequence<T>* GetSubsequence(int startIndex, int endIndex) const override {
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const override {
+        const T* data = array.Data();
         if (startIndex < 0 || endIndex >= array.GetSize() || startIndex > endIndex) {
             throw IndexOutOfRangeException("Invalid subsequence indices");
         }
-        int length = endIndex - startIndex + 1;
-        T* items = new T[length];
-        for (int i = 0; i < length; ++i) {
-            items[i] = array.Get(startIndex + i);
-        }
-        ArraySequence<T>* result = new ArraySequence<T>(items, length);
-        delete[] items;
+        IndexType length = endIndex - startIndex + 1;
+        ArraySequence<T, Allocator, InlineCapacity>* result = new ArraySequence<T, Allocator, InlineCapacity>(array.GetAllocator());
+        result->array.InsertRange(0, data + startIndex, length);
         return result;
     }
 
-    int GetLength() const override {
+    IndexType GetLength() const override {
         return array.GetSize();
     }
 
     void Append(const T& item) override {
-        int oldSize = array.GetSize();
-        array.Resize(oldSize + 1);
-        array.Set(oldSize, item);
+        array.PushBack(item);
+    }
+
+    void Append(T&& item) override {
+        array.PushBack(std::move(item));
     }
 
     void Prepend(const T& item) override {
-        int oldSize = array.GetSize();
-        array.Resize(oldSize + 1);
-        for (int i = oldSize; i > 0; --i) {
-            array.Set(i, array.Get(i - 1));
-        }
-        array.Set(0, item);
+        EmplaceAt(0, item);
     }
 
-    void InsertAt(const T& item, int index) override {
-        if (index < 0 || index > array.GetSize()) {
-            throw IndexOutOfRangeException("Invalid insert index");
-        }
-        int oldSize = array.GetSize();
-        array.Resize(oldSize + 1);
-        for (int i = oldSize; i > index; --i) {
-            array.Set(i, array.Get(i - 1));
+    void Prepend(T&& item) override {
+        EmplaceAt(0, std::move(item));
+    }
+
+    void InsertAt(const T& item, IndexType index) override {
+        EmplaceAt(index, item);
+    }
+
+    void InsertAt(T&& item, IndexType index) override {
+        EmplaceAt(index, std::move(item));
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        array.EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        EmplaceAt(0, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceAt(IndexType index, Args&&... args) {
+        array.EmplaceAt(index, std::forward<Args>(args)...);
+    }
+
+    void InsertRange(IndexType index, const T* items, IndexType count) {
+        array.InsertRange(index, items, count);
+    }
+
+    void RemoveRange(IndexType index, IndexType count) {
+        array.EraseRange(index, count);
+    }
+
+    virtual T RemoveLast() {
+        if (array.GetSize() == 0) {
+            throw EmptySequenceException();
         }
-        array.Set(index, item);
+        T value = std::move(array[array.GetSize() - 1]);
+        array.PopBack();
+        return value;
+    }
+
+    void Reserve(IndexType capacity) {
+        array.Reserve(capacity);
+    }
+
+    IndexType GetCapacity() const {
+        return array.GetCapacity();
+    }
+
+    Allocator GetAllocator() const {
+        return array.GetAllocator();
     }
 
-    Sequence<T>* Map(T (*func)(const T&)) const override {
-        ArraySequence<T>* result = new ArraySequence<T>();
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result->Append(func(array.Get(i)));
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func.
+    // Результат выделяется сразу под всю длину, элементы строятся на месте
+    template <typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const {
+        using Result = MapResult<R, Func, T>;
+        using ResultAllocator = ReboundAllocator<Allocator, Result>;
+        const T* data = array.Data();
+        auto* result = new ArraySequence<Result, ResultAllocator, InlineCapacity>(ResultAllocator(array.GetAllocator()));
+        result->Reserve(array.GetSize());
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            result->EmplaceBack(func(data[i]));
         }
         return result;
     }
 
-    Sequence<T>* Where(bool (*predicate)(const T&)) const override {
-        ArraySequence<T>* result = new ArraySequence<T>();
-        for (int i = 0; i < array.GetSize(); ++i) {
-            T current = array.Get(i);
-            if (predicate(current)) {
-                result->Append(current);
+    template <typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const {
+        const T* data = array.Data();
+        ArraySequence<T, Allocator, InlineCapacity>* result = new ArraySequence<T, Allocator, InlineCapacity>(array.GetAllocator());
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            if (predicate(data[i])) {
+                result->array.PushBack(data[i]);
             }
         }
         return result;
     }
 
-    T Reduce(T (*func)(const T&, const T&), const T& initial) const override {
+    template <typename Func>
+    T Reduce(Func func, const T& initial) const {
+        const T* data = array.Data();
         T result = initial;
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result = func(result, array.Get(i));
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            result = func(result, data[i]);
         }
         return result;
     }
 
-    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override { // Slice: удаляет N элементов начиная с позиции i и вставляет элементы из последовательности s
-        int length = array.GetSize();
+    Sequence<T>* Slice(IndexType i, IndexType N, const Sequence<T>* s = nullptr) const override { // Slice: удаляет N элементов начиная с позиции i и вставляет элементы из последовательности s
+        const T* data = array.Data();
+        IndexType length = array.GetSize();
     
         if (i < 0) {
             i = length + i;
@@ -180,56 +257,89 @@ public:
             N = length - i;
         }
         
-        ArraySequence<T>* result = new ArraySequence<T>();
-        
-        for (int j = 0; j < i; ++j) {
-            result->Append(array.Get(j));
-        }
+        ArraySequence<T, Allocator, InlineCapacity>* result = new ArraySequence<T, Allocator, InlineCapacity>(array.GetAllocator());
+        result->array.Reserve(length - N + (s != nullptr ? s->GetLength() : 0));
         
+        result->array.InsertRange(0, data, i);
+
         if (s != nullptr) {
-            for (int j = 0; j < s->GetLength(); ++j) {
-                result->Append(s->Get(j));
+            for (IndexType j = 0; j < s->GetLength(); ++j) {
+                result->array.PushBack(s->At(j));
             }
         }
 
-        for (int j = i + N; j < length; ++j) {
-            result->Append(array.Get(j));
-        }
+        result->array.InsertRange(result->array.GetSize(), data + i + N, length - i - N);
         
         return result;
     }
 
-    Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
-        ArraySequence<T>* result = new ArraySequence<T>();
-        for (int i = 0; i < array.GetSize(); ++i) {
-            Sequence<T>* subseq = func(array.Get(i));
-            for (int j = 0; j < subseq->GetLength(); ++j) {
-                result->Append(subseq->Get(j));
+    template <typename Func>
+    Sequence<T>* FlatMap(Func func) const {
+        const T* data = array.Data();
+        ArraySequence<T, Allocator, InlineCapacity>* result = new ArraySequence<T, Allocator, InlineCapacity>(array.GetAllocator());
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            Sequence<T>* subseq = func(data[i]);
+            for (IndexType j = 0; j < subseq->GetLength(); ++j) {
+                result->array.PushBack(subseq->At(j));
             }
             delete subseq;
         }
         return result;
     }
 
-    Option<T> Find(bool (*predicate)(const T&)) const override {
-        for (int i = 0; i < array.GetSize(); ++i) {
-            if (predicate(array.Get(i))) {
-                return Option<T>::Some(array.Get(i));
+    template <typename Predicate>
+    Option<T> Find(Predicate predicate) const {
+        const T* data = array.Data();
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            if (predicate(data[i])) {
+                return Option<T>::Some(data[i]);
             }
         }
         return Option<T>::None();
     }
 
-    std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
-        ArraySequence<T>* matching = new ArraySequence<T>();
-        ArraySequence<T>* notMatching = new ArraySequence<T>();
+    // Параллельные версии HOF для больших массивов. chunkSize - сколько
+    // элементов поток берёт за раз; порядок результата тот же, что у
+    // последовательных версий. Reduce требует ассоциативной func
+    template <typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* ParallelMap(Func func, IndexType chunkSize = ParallelChunkSize) const {
+        using Result = MapResult<R, Func, T>;
+        using ResultAllocator = ReboundAllocator<Allocator, Result>;
+        DynamicArray<Result, ResultAllocator, InlineCapacity> result{ResultAllocator(array.GetAllocator())};
+        ParallelMapRange(array.Data(), array.GetSize(), func, chunkSize, result);
+        return new ArraySequence<Result, ResultAllocator, InlineCapacity>(std::move(result));
+    }
+
+    template <typename Predicate>
+    Sequence<T>* ParallelWhere(Predicate predicate, IndexType chunkSize = ParallelChunkSize) const {
+        DynamicArray<T, Allocator, InlineCapacity> result(array.GetAllocator());
+        ParallelWhereRange(array.Data(), array.GetSize(), predicate, chunkSize, result);
+        return new ArraySequence<T, Allocator, InlineCapacity>(std::move(result));
+    }
+
+    template <typename Func>
+    T ParallelReduce(Func func, const T& initial, IndexType chunkSize = ParallelChunkSize) const {
+        return ParallelReduceRange(array.Data(), array.GetSize(), func, initial, chunkSize);
+    }
+
+    // Возвращает первый подходящий элемент, как Find
+    template <typename Predicate>
+    Option<T> ParallelFind(Predicate predicate, IndexType chunkSize = ParallelChunkSize) const {
+        IndexType index = ParallelFindRange(array.Data(), array.GetSize(), predicate, chunkSize);
+        return index < 0 ? Option<T>::None() : Option<T>::Some(array.Data()[index]);
+    }
 
-        for (int i = 0; i < array.GetSize(); ++i) {
-            T current = array.Get(i);
-            if (predicate(current)) {
-                matching->Append(current);
+    template <typename Predicate>
+    std::pair<Sequence<T>*, Sequence<T>*> Split(Predicate predicate) const {
+        const T* data = array.Data();
+        ArraySequence<T, Allocator, InlineCapacity>* matching = new ArraySequence<T, Allocator, InlineCapacity>(array.GetAllocator());
+        ArraySequence<T, Allocator, InlineCapacity>* notMatching = new ArraySequence<T, Allocator, InlineCapacity>(array.GetAllocator());
+
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            if (predicate(data[i])) {
+                matching->array.PushBack(data[i]);
             } else {
-                notMatching->Append(current);
+                notMatching->array.PushBack(data[i]);
             }
         }
 
@@ -237,14 +347,13 @@ public:
     }
 
     Sequence<T>* Concat(const Sequence<T>* other) const override {
-        ArraySequence<T>* result = new ArraySequence<T>();
-        
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result->Append(array.Get(i));
-        }
+        const T* data = array.Data();
+        ArraySequence<T, Allocator, InlineCapacity>* result = new ArraySequence<T, Allocator, InlineCapacity>(array.GetAllocator());
+        result->array.Reserve(array.GetSize() + other->GetLength());
+        result->array.InsertRange(0, data, array.GetSize());
         
-        for (int i = 0; i < other->GetLength(); ++i) {
-            result->Append(other->Get(i));
+        for (IndexType i = 0; i < other->GetLength(); ++i) {
+            result->array.PushBack(other->At(i));
         }
         
         return result;
@@ -0,0 +1,795 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "SequenceOps.hpp"
+#include "Exceptions.hpp"
+
+// Последовательность на B+-дереве с количествами элементов в поддеревьях:
+// внутренние узлы хранят размеры детей, поэтому Get, InsertAt и RemoveAt
+// спускаются по индексу за O(log N). Элементы лежат только в листах,
+// связанных в двусвязный список, и HOF обходят их подряд.
+// Узлы занимают по несколько строк кэша: лист - около 256 байт элементов,
+// внутренний узел - 16 пар (размер, ребёнок)
+template <typename T, typename Allocator = std::allocator<T>>
+class BTreeSequence : public SequenceOps<T, BTreeSequence<T, Allocator>> {
+public:
+    static constexpr int LeafCapacity = sizeof(T) * 4 >= 256 ? 4 : static_cast<int>(256 / sizeof(T));
+    static constexpr int Fanout = 16;
+
+private:
+    struct Leaf {
+        int count;
+        Leaf* prev;
+        Leaf* next;
+        alignas(T) unsigned char storage[sizeof(T) * LeafCapacity];
+
+        Leaf() : count(0), prev(nullptr), next(nullptr) {}
+
+        T* Items() {
+            return reinterpret_cast<T*>(storage);
+        }
+
+        const T* Items() const {
+            return reinterpret_cast<const T*>(storage);
+        }
+    };
+
+    // Дети - листья на уровне 1 и внутренние узлы выше
+    struct Inner {
+        int count;
+        IndexType sizes[Fanout];
+        void* children[Fanout];
+
+        Inner() : count(0) {}
+    };
+
+    using ElementTraits = std::allocator_traits<Allocator>;
+    using LeafAllocator = typename ElementTraits::template rebind_alloc<Leaf>;
+    using LeafTraits = std::allocator_traits<LeafAllocator>;
+    using InnerAllocator = typename ElementTraits::template rebind_alloc<Inner>;
+    using InnerTraits = std::allocator_traits<InnerAllocator>;
+
+    class BTreeEnumerator : public IEnumerator<T> {
+    private:
+        const BTreeSequence<T, Allocator>& sequence;
+        const Leaf* leaf;
+        int offset;
+        bool isBeforeFirst;
+
+    public:
+        explicit BTreeEnumerator(const BTreeSequence<T, Allocator>& sequence)
+            : sequence(sequence), leaf(nullptr), offset(0), isBeforeFirst(true) {}
+
+        bool MoveNext() override {
+            if (isBeforeFirst) {
+                leaf = sequence.first;
+                offset = 0;
+                isBeforeFirst = false;
+            } else if (leaf && ++offset == leaf->count) {
+                leaf = leaf->next;
+                offset = 0;
+            }
+            return leaf != nullptr && leaf->count > 0;
+        }
+
+        const T& Current() const override {
+            if (!leaf || offset >= leaf->count) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return leaf->Items()[offset];
+        }
+
+        void Reset() override {
+            leaf = nullptr;
+            isBeforeFirst = true;
+        }
+    };
+
+    Allocator allocator;
+    // Корень - лист при height == 0
+    void* root;
+    int height;
+    IndexType size;
+    Leaf* first;
+    Leaf* last;
+
+    static Leaf* AsLeaf(void* node) {
+        return static_cast<Leaf*>(node);
+    }
+
+    static Inner* AsInner(void* node) {
+        return static_cast<Inner*>(node);
+    }
+
+    static int Count(void* node, int level) {
+        return level == 0 ? AsLeaf(node)->count : AsInner(node)->count;
+    }
+
+    static IndexType SizeOf(void* node, int level) {
+        if (level == 0) {
+            return AsLeaf(node)->count;
+        }
+        IndexType total = 0;
+        Inner* inner = AsInner(node);
+        for (int i = 0; i < inner->count; ++i) {
+            total += inner->sizes[i];
+        }
+        return total;
+    }
+
+    template <typename... Args>
+    void Construct(T* place, Args&&... args) {
+        ElementTraits::construct(allocator, place, std::forward<Args>(args)...);
+    }
+
+    void Destroy(T* place) {
+        ElementTraits::destroy(allocator, place);
+    }
+
+    Leaf* NewLeaf() {
+        LeafAllocator leafAllocator(allocator);
+        Leaf* leaf = LeafTraits::allocate(leafAllocator, 1);
+        LeafTraits::construct(leafAllocator, leaf);
+        return leaf;
+    }
+
+    void FreeLeaf(Leaf* leaf) {
+        LeafAllocator leafAllocator(allocator);
+        LeafTraits::destroy(leafAllocator, leaf);
+        LeafTraits::deallocate(leafAllocator, leaf, 1);
+    }
+
+    Inner* NewInner() {
+        InnerAllocator innerAllocator(allocator);
+        Inner* inner = InnerTraits::allocate(innerAllocator, 1);
+        InnerTraits::construct(innerAllocator, inner);
+        return inner;
+    }
+
+    void FreeInner(Inner* inner) {
+        InnerAllocator innerAllocator(allocator);
+        InnerTraits::destroy(innerAllocator, inner);
+        InnerTraits::deallocate(innerAllocator, inner, 1);
+    }
+
+    void FreeSubtree(void* node, int level) {
+        if (level == 0) {
+            Leaf* leaf = AsLeaf(node);
+            for (int i = 0; i < leaf->count; ++i) {
+                Destroy(leaf->Items() + i);
+            }
+            FreeLeaf(leaf);
+            return;
+        }
+        Inner* inner = AsInner(node);
+        for (int i = 0; i < inner->count; ++i) {
+            FreeSubtree(inner->children[i], level - 1);
+        }
+        FreeInner(inner);
+    }
+
+    // Новый лист сразу после leaf в списке листьев
+    Leaf* LinkLeafAfter(Leaf* leaf) {
+        Leaf* right = NewLeaf();
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next) {
+            leaf->next->prev = right;
+        } else {
+            last = right;
+        }
+        leaf->next = right;
+        return right;
+    }
+
+    void UnlinkLeaf(Leaf* leaf) {
+        if (leaf->prev) {
+            leaf->prev->next = leaf->next;
+        } else {
+            first = leaf->next;
+        }
+        if (leaf->next) {
+            leaf->next->prev = leaf->prev;
+        } else {
+            last = leaf->prev;
+        }
+        FreeLeaf(leaf);
+    }
+
+    // Переносит элементы [from, count) leaf в конец target
+    void MoveItems(Leaf* leaf, int from, Leaf* target) {
+        for (int i = from; i < leaf->count; ++i) {
+            Construct(target->Items() + target->count++, std::move(leaf->Items()[i]));
+            Destroy(leaf->Items() + i);
+        }
+        leaf->count = from;
+    }
+
+    template <typename... Args>
+    void PlaceInLeaf(Leaf* leaf, int position, Args&&... args) {
+        T* items = leaf->Items();
+        if (position == leaf->count) {
+            Construct(items + position, std::forward<Args>(args)...);
+        } else {
+            T value(std::forward<Args>(args)...);
+            Construct(items + leaf->count, std::move(items[leaf->count - 1]));
+            std::move_backward(items + position, items + leaf->count - 1, items + leaf->count);
+            items[position] = std::move(value);
+        }
+        ++leaf->count;
+    }
+
+    // Вставка в лист; при переполнении возвращает новый правый лист.
+    // Вставка в край полного листа его не делит пополам, а начинает новый,
+    // поэтому последовательное заполнение даёт полностью занятые листья
+    template <typename... Args>
+    Leaf* InsertIntoLeaf(Leaf* leaf, int position, Args&&... args) {
+        if (leaf->count < LeafCapacity) {
+            PlaceInLeaf(leaf, position, std::forward<Args>(args)...);
+            return nullptr;
+        }
+        T value(std::forward<Args>(args)...);
+        int splitAt = position == LeafCapacity ? LeafCapacity : position == 0 ? 0 : LeafCapacity / 2;
+        Leaf* right = LinkLeafAfter(leaf);
+        MoveItems(leaf, splitAt, right);
+        if (position > splitAt || (position == splitAt && splitAt == LeafCapacity)) {
+            PlaceInLeaf(right, position - splitAt, std::move(value));
+        } else {
+            PlaceInLeaf(leaf, position, std::move(value));
+        }
+        return right;
+    }
+
+    // Вставка ребёнка в позицию position; при переполнении возвращает новый правый узел
+    Inner* InsertChild(Inner* inner, int position, void* child, IndexType childSize) {
+        if (inner->count == Fanout) {
+            int splitAt = position == Fanout ? Fanout : Fanout / 2;
+            Inner* right = NewInner();
+            for (int i = splitAt; i < inner->count; ++i) {
+                right->children[right->count] = inner->children[i];
+                right->sizes[right->count++] = inner->sizes[i];
+            }
+            inner->count = splitAt;
+            if (position > splitAt || (position == splitAt && splitAt == Fanout)) {
+                InsertChild(right, position - splitAt, child, childSize);
+            } else {
+                InsertChild(inner, position, child, childSize);
+            }
+            return right;
+        }
+        for (int i = inner->count; i > position; --i) {
+            inner->children[i] = inner->children[i - 1];
+            inner->sizes[i] = inner->sizes[i - 1];
+        }
+        inner->children[position] = child;
+        inner->sizes[position] = childSize;
+        ++inner->count;
+        return nullptr;
+    }
+
+    template <typename... Args>
+    void* InsertInto(void* node, int level, IndexType index, Args&&... args) {
+        if (level == 0) {
+            return InsertIntoLeaf(AsLeaf(node), static_cast<int>(index), std::forward<Args>(args)...);
+        }
+        Inner* inner = AsInner(node);
+        int child = 0;
+        while (child < inner->count - 1 && index > inner->sizes[child]) {
+            index -= inner->sizes[child];
+            ++child;
+        }
+        void* split = InsertInto(inner->children[child], level - 1, index, std::forward<Args>(args)...);
+        ++inner->sizes[child];
+        if (!split) {
+            return nullptr;
+        }
+        IndexType splitSize = SizeOf(split, level - 1);
+        inner->sizes[child] -= splitSize;
+        return InsertChild(inner, child + 1, split, splitSize);
+    }
+
+    template <typename... Args>
+    void InsertNode(IndexType index, Args&&... args) {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        if (!root) {
+            Leaf* leaf = NewLeaf();
+            root = leaf;
+            first = leaf;
+            last = leaf;
+            height = 0;
+        }
+        void* split = InsertInto(root, height, index, std::forward<Args>(args)...);
+        ++size;
+        if (split) {
+            IndexType splitSize = SizeOf(split, height);
+            Inner* newRoot = NewInner();
+            newRoot->children[0] = root;
+            newRoot->sizes[0] = size - splitSize;
+            newRoot->children[1] = split;
+            newRoot->sizes[1] = splitSize;
+            newRoot->count = 2;
+            root = newRoot;
+            ++height;
+        }
+    }
+
+    void RemoveChild(Inner* inner, int position) {
+        for (int i = position; i < inner->count - 1; ++i) {
+            inner->children[i] = inner->children[i + 1];
+            inner->sizes[i] = inner->sizes[i + 1];
+        }
+        --inner->count;
+    }
+
+    // Восстанавливает заполненность ребёнка child слиянием с соседом
+    // или заимствованием у него одного элемента
+    void Rebalance(Inner* inner, int child, int childLevel) {
+        int capacity = childLevel == 0 ? LeafCapacity : Fanout;
+        if (Count(inner->children[child], childLevel) >= capacity / 2 || inner->count < 2) {
+            return;
+        }
+        int left = child > 0 ? child - 1 : child;
+        int right = left + 1;
+        void* leftNode = inner->children[left];
+        void* rightNode = inner->children[right];
+        int leftCount = Count(leftNode, childLevel);
+        int rightCount = Count(rightNode, childLevel);
+
+        if (leftCount + rightCount <= capacity) {
+            if (childLevel == 0) {
+                Leaf* rightLeaf = AsLeaf(rightNode);
+                MoveItems(rightLeaf, 0, AsLeaf(leftNode));
+                UnlinkLeaf(rightLeaf);
+            } else {
+                Inner* leftInner = AsInner(leftNode);
+                Inner* rightInner = AsInner(rightNode);
+                for (int i = 0; i < rightInner->count; ++i) {
+                    leftInner->children[leftInner->count] = rightInner->children[i];
+                    leftInner->sizes[leftInner->count++] = rightInner->sizes[i];
+                }
+                FreeInner(rightInner);
+            }
+            inner->sizes[left] += inner->sizes[right];
+            RemoveChild(inner, right);
+            return;
+        }
+
+        IndexType moved;
+        if (childLevel == 0) {
+            Leaf* leftLeaf = AsLeaf(leftNode);
+            Leaf* rightLeaf = AsLeaf(rightNode);
+            if (leftCount < rightCount) {
+                Construct(leftLeaf->Items() + leftLeaf->count++, std::move(rightLeaf->Items()[0]));
+                T* items = rightLeaf->Items();
+                std::move(items + 1, items + rightLeaf->count, items);
+                Destroy(items + --rightLeaf->count);
+            } else {
+                PlaceInLeaf(rightLeaf, 0, std::move(leftLeaf->Items()[leftLeaf->count - 1]));
+                Destroy(leftLeaf->Items() + --leftLeaf->count);
+            }
+            moved = 1;
+        } else {
+            Inner* leftInner = AsInner(leftNode);
+            Inner* rightInner = AsInner(rightNode);
+            if (leftCount < rightCount) {
+                moved = rightInner->sizes[0];
+                InsertChild(leftInner, leftInner->count, rightInner->children[0], moved);
+                RemoveChild(rightInner, 0);
+            } else {
+                moved = leftInner->sizes[leftInner->count - 1];
+                InsertChild(rightInner, 0, leftInner->children[leftInner->count - 1], moved);
+                --leftInner->count;
+            }
+        }
+        if (leftCount < rightCount) {
+            inner->sizes[left] += moved;
+            inner->sizes[right] -= moved;
+        } else {
+            inner->sizes[left] -= moved;
+            inner->sizes[right] += moved;
+        }
+    }
+
+    T RemoveFrom(void* node, int level, IndexType index) {
+        if (level == 0) {
+            Leaf* leaf = AsLeaf(node);
+            T* items = leaf->Items();
+            int position = static_cast<int>(index);
+            T value = std::move(items[position]);
+            std::move(items + position + 1, items + leaf->count, items + position);
+            Destroy(items + --leaf->count);
+            return value;
+        }
+        Inner* inner = AsInner(node);
+        int child = 0;
+        while (index >= inner->sizes[child]) {
+            index -= inner->sizes[child];
+            ++child;
+        }
+        T value = RemoveFrom(inner->children[child], level - 1, index);
+        --inner->sizes[child];
+        Rebalance(inner, child, level - 1);
+        return value;
+    }
+
+    // Лист, содержащий index, и позиция index в нём
+    const Leaf* LeafAt(IndexType index, int& offset) const {
+        void* node = root;
+        for (int level = height; level > 0; --level) {
+            Inner* inner = AsInner(node);
+            int child = 0;
+            while (index >= inner->sizes[child]) {
+                index -= inner->sizes[child];
+                ++child;
+            }
+            node = inner->children[child];
+        }
+        offset = static_cast<int>(index);
+        return AsLeaf(node);
+    }
+
+    const T& Cell(IndexType index) const {
+        int offset;
+        return LeafAt(index, offset)->Items()[offset];
+    }
+
+    // Обход [begin, end): один спуск к листу с begin, дальше по списку
+    // листьев, то есть O(log N + end - begin)
+    template <typename Visitor>
+    void VisitRange(IndexType begin, IndexType end, Visitor visit) const {
+        if (begin >= end) {
+            return;
+        }
+        int offset;
+        const Leaf* leaf = LeafAt(begin, offset);
+        for (IndexType remaining = end - begin; remaining > 0; leaf = leaf->next, offset = 0) {
+            const T* items = leaf->Items();
+            int stop = leaf->count - offset < remaining ? leaf->count : offset + static_cast<int>(remaining);
+            for (int i = offset; i < stop; ++i) {
+                visit(items[i]);
+            }
+            remaining -= stop - offset;
+        }
+    }
+
+    template <typename Visitor>
+    void Visit(Visitor visit) const {
+        for (const Leaf* leaf = first; leaf; leaf = leaf->next) {
+            const T* items = leaf->Items();
+            for (int i = 0; i < leaf->count; ++i) {
+                visit(items[i]);
+            }
+        }
+    }
+
+    BTreeSequence<T, Allocator>* CreateEmpty() const {
+        return new BTreeSequence<T, Allocator>(allocator);
+    }
+
+    void Steal(BTreeSequence& other) noexcept {
+        root = other.root;
+        height = other.height;
+        size = other.size;
+        first = other.first;
+        last = other.last;
+        other.root = nullptr;
+        other.height = 0;
+        other.size = 0;
+        other.first = nullptr;
+        other.last = nullptr;
+    }
+
+public:
+    BTreeSequence() : allocator(), root(nullptr), height(0), size(0), first(nullptr), last(nullptr) {}
+    explicit BTreeSequence(const Allocator& allocator)
+        : allocator(allocator), root(nullptr), height(0), size(0), first(nullptr), last(nullptr) {}
+    BTreeSequence(const T* items, IndexType count, const Allocator& allocator = Allocator())
+        : BTreeSequence(allocator) {
+        if (count < 0) {
+            throw InvalidSizeException("Count cannot be negative");
+        }
+        for (IndexType i = 0; i < count; ++i) {
+            Append(items[i]);
+        }
+    }
+
+    BTreeSequence(const BTreeSequence& other)
+        : BTreeSequence(ElementTraits::select_on_container_copy_construction(other.allocator)) {
+        other.Visit([&](const T& item) { Append(item); });
+    }
+
+    BTreeSequence(BTreeSequence&& other) noexcept
+        : allocator(std::move(other.allocator)), root(nullptr), height(0), size(0),
+          first(nullptr), last(nullptr) {
+        Steal(other);
+    }
+
+    BTreeSequence& operator=(const BTreeSequence& other) {
+        if (this != &other) {
+            Clear();
+            other.Visit([&](const T& item) { Append(item); });
+        }
+        return *this;
+    }
+
+    BTreeSequence& operator=(BTreeSequence&& other)
+        noexcept(ElementTraits::propagate_on_container_move_assignment::value) {
+        if (this == &other) {
+            return *this;
+        }
+        Clear();
+        if (ElementTraits::propagate_on_container_move_assignment::value) {
+            allocator = std::move(other.allocator);
+            Steal(other);
+        } else if (allocator == other.allocator) {
+            Steal(other);
+        } else {
+            for (Leaf* leaf = other.first; leaf; leaf = leaf->next) {
+                for (int i = 0; i < leaf->count; ++i) {
+                    Append(std::move(leaf->Items()[i]));
+                }
+            }
+            other.Clear();
+        }
+        return *this;
+    }
+
+    ~BTreeSequence() {
+        Clear();
+    }
+
+    T Get(IndexType index) const override {
+        return At(index);
+    }
+
+    T GetFirst() const override {
+        return FirstRef();
+    }
+
+    T GetLast() const override {
+        return LastRef();
+    }
+
+    const T& At(IndexType index) const override {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return Cell(index);
+    }
+
+    const T& FirstRef() const override {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        return first->Items()[0];
+    }
+
+    const T& LastRef() const override {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        return last->Items()[last->count - 1];
+    }
+
+    Option<T> TryGet(IndexType index) const override {
+        if (index < 0 || index >= size) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(index));
+    }
+
+    Option<T> TryGetFirst() const override {
+        if (size == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(FirstRef());
+    }
+
+    Option<T> TryGetLast() const override {
+        if (size == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(LastRef());
+    }
+
+    IndexType GetLength() const override {
+        return size;
+    }
+
+    int GetHeight() const {
+        return height;
+    }
+
+    Allocator GetAllocator() const {
+        return allocator;
+    }
+
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const override {
+        if (startIndex < 0 || endIndex >= size || startIndex > endIndex) {
+            throw IndexOutOfRangeException("Invalid subsequence indices");
+        }
+        BTreeSequence<T, Allocator>* result = CreateEmpty();
+        VisitRange(startIndex, endIndex + 1, [&](const T& item) { result->Append(item); });
+        return result;
+    }
+
+    void Append(const T& item) override {
+        InsertNode(size, item);
+    }
+
+    void Append(T&& item) override {
+        InsertNode(size, std::move(item));
+    }
+
+    void Prepend(const T& item) override {
+        InsertNode(0, item);
+    }
+
+    void Prepend(T&& item) override {
+        InsertNode(0, std::move(item));
+    }
+
+    void InsertAt(const T& item, IndexType index) override {
+        InsertNode(index, item);
+    }
+
+    void InsertAt(T&& item, IndexType index) override {
+        InsertNode(index, std::move(item));
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        InsertNode(size, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        InsertNode(0, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceAt(IndexType index, Args&&... args) {
+        InsertNode(index, std::forward<Args>(args)...);
+    }
+
+    T RemoveAt(IndexType index) {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        T value = RemoveFrom(root, height, index);
+        --size;
+        while (height > 0 && AsInner(root)->count == 1) {
+            Inner* oldRoot = AsInner(root);
+            root = oldRoot->children[0];
+            FreeInner(oldRoot);
+            --height;
+        }
+        if (size == 0) {
+            FreeLeaf(AsLeaf(root));
+            root = nullptr;
+            first = nullptr;
+            last = nullptr;
+        }
+        return value;
+    }
+
+    void Clear() {
+        if (root) {
+            FreeSubtree(root, height);
+        }
+        root = nullptr;
+        height = 0;
+        size = 0;
+        first = nullptr;
+        last = nullptr;
+    }
+
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func
+    template <typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const {
+        using Result = MapResult<R, Func, T>;
+        using ResultAllocator = ReboundAllocator<Allocator, Result>;
+        auto* result = new BTreeSequence<Result, ResultAllocator>(ResultAllocator(allocator));
+        Visit([&](const T& item) { result->EmplaceBack(func(item)); });
+        return result;
+    }
+
+    template <typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const {
+        BTreeSequence<T, Allocator>* result = CreateEmpty();
+        Visit([&](const T& item) {
+            if (predicate(item)) {
+                result->Append(item);
+            }
+        });
+        return result;
+    }
+
+    template <typename Func>
+    T Reduce(Func func, const T& initial) const {
+        T result = initial;
+        Visit([&](const T& item) { result = func(result, item); });
+        return result;
+    }
+
+    Sequence<T>* Slice(IndexType i, IndexType N, const Sequence<T>* s = nullptr) const override {
+        IndexType length = size;
+
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+
+        BTreeSequence<T, Allocator>* result = CreateEmpty();
+        auto append = [&](const T& item) { result->Append(item); };
+        VisitRange(0, i, append);
+        if (s != nullptr) {
+            for (IndexType j = 0; j < s->GetLength(); ++j) {
+                result->Append(s->At(j));
+            }
+        }
+        VisitRange(i + N, length, append);
+        return result;
+    }
+
+    template <typename Func>
+    Sequence<T>* FlatMap(Func func) const {
+        BTreeSequence<T, Allocator>* result = CreateEmpty();
+        Visit([&](const T& item) {
+            Sequence<T>* subseq = func(item);
+            for (IndexType j = 0; j < subseq->GetLength(); ++j) {
+                result->Append(subseq->At(j));
+            }
+            delete subseq;
+        });
+        return result;
+    }
+
+    template <typename Predicate>
+    Option<T> Find(Predicate predicate) const {
+        for (const Leaf* leaf = first; leaf; leaf = leaf->next) {
+            for (int i = 0; i < leaf->count; ++i) {
+                if (predicate(leaf->Items()[i])) {
+                    return Option<T>::Some(leaf->Items()[i]);
+                }
+            }
+        }
+        return Option<T>::None();
+    }
+
+    template <typename Predicate>
+    std::pair<Sequence<T>*, Sequence<T>*> Split(Predicate predicate) const {
+        BTreeSequence<T, Allocator>* matching = CreateEmpty();
+        BTreeSequence<T, Allocator>* notMatching = CreateEmpty();
+        Visit([&](const T& item) {
+            if (predicate(item)) {
+                matching->Append(item);
+            } else {
+                notMatching->Append(item);
+            }
+        });
+        return std::make_pair(matching, notMatching);
+    }
+
+    Sequence<T>* Concat(const Sequence<T>* other) const override {
+        BTreeSequence<T, Allocator>* result = CreateEmpty();
+        Visit([&](const T& item) { result->Append(item); });
+        for (IndexType i = 0; i < other->GetLength(); ++i) {
+            result->Append(other->At(i));
+        }
+        return result;
+    }
+
+    IEnumerator<T>* GetEnumerator() const override {
+        return new BTreeEnumerator(*this);
+    }
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+// Политика проверки индексов в публичных аксессорах контейнеров.
+// По умолчанию проверки включены; сборка с -DBOUNDS_CHECK=0 убирает их,
+// внутренние циклы работают без проверок при любой политике
+#ifndef BOUNDS_CHECK
+#define BOUNDS_CHECK 1
+#endif
+
+inline constexpr bool BoundsCheckEnabled = BOUNDS_CHECK != 0;
@@ -5,48 +5,58 @@
 #include "Option.hpp"
 #include "IEnumerable.hpp"
 #include <algorithm>
+#include <memory>
+#include <vector>
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>,
+         template <typename, typename> class List = LinkedList>
 class Deque : public IEnumerable<T> {
 private:
-    ListSequence<T> items;
+    using Cursor = typename ListSequence<T, Allocator, List>::Cursor;
+
+    ListSequence<T, Allocator, List> items;
 
     class DequeEnumerator : public IEnumerator<T> {
     private:
-        const ListSequence<T>& sequence;
-        int currentIndex;
-        T currentValue;
+        const ListSequence<T, Allocator, List>& sequence;
+        Cursor current;
+        bool isBeforeFirst;
 
     public:
-        explicit DequeEnumerator(const ListSequence<T>& seq)
+        explicit DequeEnumerator(const ListSequence<T, Allocator, List>& seq)
             : sequence(seq)
-            , currentIndex(-1)
+            , current()
+            , isBeforeFirst(true)
         {
         }
 
         bool MoveNext() override {
-            if (currentIndex + 1 < sequence.GetLength()) {
-                currentIndex++;
-                currentValue = sequence.Get(currentIndex);
-                return true;
+            if (isBeforeFirst) {
+                current = sequence.First();
+                isBeforeFirst = false;
+            } else {
+                current.MoveNext();
             }
-            return false;
+            return current.IsValid();
         }
 
         const T& Current() const override {
-            if (currentIndex < 0 || currentIndex >= sequence.GetLength()) {
+            if (!current.IsValid()) {
                 throw InvalidStateException("Enumerator is not in a valid position");
             }
-            return currentValue;
+            return current.Get();
         }
 
         void Reset() override {
-            currentIndex = -1;
+            current = Cursor();
+            isBeforeFirst = true;
         }
     };
 
+
 public:
     Deque() = default;
+    explicit Deque(const Allocator& allocator) : items(allocator) {}
 
     void PushFront(const T& item) {
         items.Prepend(item);
@@ -56,95 +66,119 @@ public:
         items.Append(item);
     }
 
+    void PushFront(T&& item) {
+        items.Prepend(std::move(item));
+    }
+
+    void PushBack(T&& item) {
+        items.Append(std::move(item));
+    }
+
+    template<typename... Args>
+    void EmplaceFront(Args&&... args) {
+        items.EmplaceFront(std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void EmplaceBack(Args&&... args) {
+        items.EmplaceBack(std::forward<Args>(args)...);
+    }
+
     Option<T> PopFront() {
         if (items.GetLength() == 0) {
             return Option<T>::None();
         }
-        T value = items.GetFirst();
-        ListSequence<T> newItems;
-        for (int i = 1; i < items.GetLength(); ++i) {
-            newItems.Append(items.Get(i));
-        }
-        items = newItems;
-        return Option<T>::Some(value);
+        return Option<T>::Some(items.RemoveFirst());
     }
 
     Option<T> PopBack() {
         if (items.GetLength() == 0) {
             return Option<T>::None();
         }
-        T value = items.GetLast();
-        ListSequence<T> newItems;
-        for (int i = 0; i < items.GetLength() - 1; ++i) {
-            newItems.Append(items.Get(i));
-        }
-        items = newItems;
-        return Option<T>::Some(value);
+        return Option<T>::Some(items.RemoveLast());
     }
 
     Option<T> PeekFront() const {
         if (items.GetLength() == 0) {
             return Option<T>::None();
         }
-        return Option<T>::Some(items.GetFirst());
+        return Option<T>::Some(items.FirstRef());
     }
 
     Option<T> PeekBack() const {
         if (items.GetLength() == 0) {
             return Option<T>::None();
         }
-        return Option<T>::Some(items.GetLast());
+        return Option<T>::Some(items.LastRef());
     }
 
     bool IsEmpty() const {
         return items.GetLength() == 0;
     }
 
-    int GetSize() const {
+    IndexType GetSize() const {
         return items.GetLength();
     }
 
-    T Get(int index) const {
+    Allocator GetAllocator() const {
+        return items.GetAllocator();
+    }
+
+    T Get(IndexType index) const {
         return items.Get(index);
     }
 
-    Sequence<T>* Map(T (*func)(const T&)) const {
-        return items.Map(func);
+    const T& At(IndexType index) const {
+        return items.At(index);
+    }
+
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func
+    template<typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const {
+        return items.template Map<R>(func);
     }
 
-    Sequence<T>* Where(bool (*predicate)(const T&)) const {
+    template<typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const {
         return items.Where(predicate);
     }
 
-    T Reduce(T (*func)(const T&, const T&), const T& initial) const {
+    template<typename Func>
+    T Reduce(Func func, const T& initial) const {
         return items.Reduce(func, initial);
     }
 
-    Sequence<T>* GetSubsequence(int startIndex, int endIndex) const {
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const {
         return items.GetSubsequence(startIndex, endIndex);
     }
 
-    Deque<T>* Concat(const Deque<T>* other) const {
-        Deque<T>* result = new Deque<T>();
-        for (int i = 0; i < items.GetLength(); ++i) {
-            result->PushBack(items.Get(i));
+    Deque<T, Allocator, List>* Concat(const Deque<T, Allocator, List>* other) const {
+        Deque<T, Allocator, List>* result = new Deque<T, Allocator, List>(items.GetAllocator());
+        for (Cursor current = items.First(); current.IsValid(); current.MoveNext()) {
+            result->PushBack(current.Get());
         }
-        for (int i = 0; i < other->GetSize(); ++i) {
-            result->PushBack(other->Get(i));
+        for (Cursor current = other->items.First(); current.IsValid(); current.MoveNext()) {
+            result->PushBack(current.Get());
         }
         return result;
     }
 
-    std::pair<Deque<T>*, Deque<T>*> Split(bool (*predicate)(const T&)) const {
-        Deque<T>* matching = new Deque<T>();
-        Deque<T>* notMatching = new Deque<T>();
+    // Переносит элементы other в конец дека без копирования
+    void ConcatInPlace(Deque<T, Allocator, List>& other) {
+        items.ConcatInPlace(other.items);
+    }
+
+    template<typename Predicate>
+    std::pair<Deque<T, Allocator, List>*, Deque<T, Allocator, List>*> Split(Predicate predicate) const {
+        Deque<T, Allocator, List>* matching = new Deque<T, Allocator, List>(items.GetAllocator());
+        Deque<T, Allocator, List>* notMatching = new Deque<T, Allocator, List>(items.GetAllocator());
 
-        for (int i = 0; i < items.GetLength(); ++i) {
-            T current = items.Get(i);
-            if (predicate(current)) {
-                matching->PushBack(current);
+        for (Cursor current = items.First(); current.IsValid(); current.MoveNext()) {
+            const T& item = current.Get();
+            if (predicate(item)) {
+                matching->PushBack(item);
             } else {
-                notMatching->PushBack(current);
+                notMatching->PushBack(item);
             }
         }
 
@@ -152,7 +186,7 @@ public:
     }
 
     Sequence<T>* GetSequence() const {
-        return new ListSequence<T>(items);
+        return new ListSequence<T, Allocator, List>(items);
     }
 
     IEnumerator<T>* GetEnumerator() const override {
@@ -163,18 +197,19 @@ public:
         if (items.GetLength() <= 1) return;
 
         T* array = new T[items.GetLength()];
-        for (int i = 0; i < items.GetLength(); ++i) {
-            array[i] = items.Get(i);
+        IndexType index = 0;
+        for (Cursor current = items.First(); current.IsValid(); current.MoveNext()) {
+            array[index++] = current.Get();
         }
 
         std::sort(array, array + items.GetLength());
 
-        ListSequence<T> sortedItems;
-        for (int i = 0; i < items.GetLength(); ++i) {
-            sortedItems.Append(array[i]);
+        ListSequence<T, Allocator, List> sortedItems(items.GetAllocator());
+        for (IndexType i = 0; i < items.GetLength(); ++i) {
+            sortedItems.Append(std::move(array[i]));
         }
 
-        items = sortedItems;
+        items = std::move(sortedItems);
         delete[] array;
     }
 
@@ -182,18 +217,19 @@ public:
         if (items.GetLength() <= 1) return;
 
         T* array = new T[items.GetLength()];
-        for (int i = 0; i < items.GetLength(); ++i) {
-            array[i] = items.Get(i);
+        IndexType index = 0;
+        for (Cursor current = items.First(); current.IsValid(); current.MoveNext()) {
+            array[index++] = current.Get();
         }
 
         std::sort(array, array + items.GetLength(), compare);
 
-        ListSequence<T> sortedItems;
-        for (int i = 0; i < items.GetLength(); ++i) {
-            sortedItems.Append(array[i]);
+        ListSequence<T, Allocator, List> sortedItems(items.GetAllocator());
+        for (IndexType i = 0; i < items.GetLength(); ++i) {
+            sortedItems.Append(std::move(array[i]));
         }
 
-        items = sortedItems;
+        items = std::move(sortedItems);
         delete[] array;
     }
 
@@ -201,10 +237,12 @@ public:
         if (subsequence->GetLength() == 0) return true;
         if (subsequence->GetLength() > items.GetLength()) return false;
 
-        for (int i = 0; i <= items.GetLength() - subsequence->GetLength(); ++i) {
+        Cursor start = items.First();
+        for (IndexType i = 0; i <= items.GetLength() - subsequence->GetLength(); ++i, start.MoveNext()) {
             bool found = true;
-            for (int j = 0; j < subsequence->GetLength(); ++j) {
-                if (!(items.Get(i + j) == subsequence->Get(j))) {
+            Cursor current = start;
+            for (IndexType j = 0; j < subsequence->GetLength(); ++j, current.MoveNext()) {
+                if (!(current.Get() == subsequence->At(j))) {
                     found = false;
                     break;
                 }
@@ -214,46 +252,45 @@ public:
         return false;
     }
 
-    static Deque<T>* Merge(const Deque<T>* first, const Deque<T>* second) {
-        Deque<T>* result = new Deque<T>();
+    static Deque<T, Allocator, List>* Merge(const Deque<T, Allocator, List>* first, const Deque<T, Allocator, List>* second) {
+        Deque<T, Allocator, List>* result = new Deque<T, Allocator, List>(first->GetAllocator());
 
-        int i = 0, j = 0;
-        while (i < first->GetSize() && j < second->GetSize()) {
-            if (first->Get(i) <= second->Get(j)) {
-                result->PushBack(first->Get(i));
-                i++;
+        Cursor i = first->items.First();
+        Cursor j = second->items.First();
+        while (i.IsValid() && j.IsValid()) {
+            if (i.Get() <= j.Get()) {
+                result->PushBack(i.Get());
+                i.MoveNext();
             } else {
-                result->PushBack(second->Get(j));
-                j++;
+                result->PushBack(j.Get());
+                j.MoveNext();
             }
         }
 
-        while (i < first->GetSize()) {
-            result->PushBack(first->Get(i));
-            i++;
+        for (; i.IsValid(); i.MoveNext()) {
+            result->PushBack(i.Get());
         }
 
-        while (j < second->GetSize()) {
-            result->PushBack(second->Get(j));
-            j++;
+        for (; j.IsValid(); j.MoveNext()) {
+            result->PushBack(j.Get());
         }
 
         return result;
     }
 
-    static Deque<T>* Merge(const Deque<T>* first, const Deque<T>* second, 
+    static Deque<T, Allocator, List>* Merge(const Deque<T, Allocator, List>* first, const Deque<T, Allocator, List>* second, 
                           bool (*compare)(const T&, const T&)) {
-        Deque<T>* result = new Deque<T>();
+        Deque<T, Allocator, List>* result = new Deque<T, Allocator, List>(first->GetAllocator());
         
         std::vector<T> firstElements;
         std::vector<T> secondElements;
 
-        for (int i = first->GetSize() - 1; i >= 0; i--) {
-            firstElements.push_back(first->Get(i));
+        for (Cursor current = first->items.Last(); current.IsValid(); current.MovePrev()) {
+            firstElements.push_back(current.Get());
         }
         
-        for (int i = second->GetSize() - 1; i >= 0; i--) {
-            secondElements.push_back(second->Get(i));
+        for (Cursor current = second->items.Last(); current.IsValid(); current.MovePrev()) {
+            secondElements.push_back(current.Get());
         }
         
         size_t i = 0, j = 0;
@@ -1,117 +1,680 @@
 #pragma once
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "BoundsCheck.hpp"
 #include "Exceptions.hpp"
+#include "Index.hpp"
+
+// Сырая память под Capacity элементов внутри самого объекта
+template <typename T, int Capacity>
+struct InlineStorage {
+    alignas(T) unsigned char bytes[sizeof(T) * Capacity];
+
+    // Пустой конструктор: память не обнуляется, но член считается
+    // инициализированным до того, как items получит его адрес
+    InlineStorage() {}
+
+    T* Data() {
+        return reinterpret_cast<T*>(bytes);
+    }
+
+    const T* Data() const {
+        return reinterpret_cast<const T*>(bytes);
+    }
+};
 
 template <typename T>
+struct InlineStorage<T, 0> {
+    T* Data() {
+        return nullptr;
+    }
+
+    const T* Data() const {
+        return nullptr;
+    }
+};
+
+// Есть ли у аллокатора собственный construct: если есть, побайтное
+// копирование обошло бы его
+template <typename Allocator, typename T, typename = void>
+struct HasCustomConstruct : std::false_type {};
+
+template <typename Allocator, typename T>
+struct HasCustomConstruct<Allocator, T, std::void_t<decltype(
+    std::declval<Allocator&>().construct(std::declval<T*>(), std::declval<const T&>()))>>
+    : std::true_type {};
+
+// Буфер выделяется без конструирования элементов: живыми являются только
+// size ячеек начиная с items, остальное - сырая память. Перед items может
+// оставаться frontSlack свободных ячеек, поэтому добавление в начало стоит
+// amortized O(1), а вставка и удаление сдвигают более короткую сторону.
+// Первые InlineCapacity элементов хранятся внутри объекта, и к аллокатору
+// массив обращается только при переполнении встроенного буфера
+template <typename T, typename Allocator = std::allocator<T>, int InlineCapacity = 0>
 class DynamicArray {
 private:
+    static_assert(InlineCapacity >= 0, "Inline capacity cannot be negative");
+
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    Allocator allocator;
+    // Объявлен раньше items: конструкторы инициализируют items его адресом
+    InlineStorage<T, InlineCapacity> inlineStorage;
     T* items;
-    int size;
-    int capacity;  // для будущего)
+    IndexType size;
+    // Ёмкость считается от items; весь буфер - frontSlack + capacity ячеек
+    IndexType capacity;
+    IndexType frontSlack;
+
+    static const IndexType MinCapacity = 4;
+
+    // Тривиально копируемые элементы копируются, сдвигаются и переносятся
+    // целыми блоками через memcpy/memmove
+    static constexpr bool BulkCopy = std::is_trivially_copyable<T>::value
+        && (std::is_same<Allocator, std::allocator<T>>::value
+            || !HasCustomConstruct<Allocator, T>::value);
+
+    static void CopyBytes(T* destination, const T* source, IndexType count) {
+        if (count > 0) {
+            std::memcpy(static_cast<void*>(destination), source, sizeof(T) * count);
+        }
+    }
+
+    static void MoveBytes(T* destination, const T* source, IndexType count) {
+        if (count > 0) {
+            std::memmove(static_cast<void*>(destination), source, sizeof(T) * count);
+        }
+    }
+
+    bool IsInline() const {
+        return InlineCapacity > 0 && items == inlineStorage.Data();
+    }
+
+    static IndexType EffectiveCapacity(IndexType count) {
+        return count < InlineCapacity ? InlineCapacity : count;
+    }
+
+    // count должен быть получен через EffectiveCapacity: запрос, который
+    // помещается во встроенный буфер, отдаёт именно его
+    T* Allocate(IndexType count) {
+        if (count <= InlineCapacity) {
+            return inlineStorage.Data();
+        }
+        return AllocatorTraits::allocate(allocator, count);
+    }
+
+    // Буфер с запасом спереди всегда берётся у аллокатора, так что
+    // встроенный буфер никогда не имеет frontSlack
+    T* AllocateBuffer(IndexType front, IndexType count) {
+        if (front == 0) {
+            return Allocate(count);
+        }
+        return AllocatorTraits::allocate(allocator, front + count);
+    }
+
+    void Deallocate(T* buffer, IndexType count) {
+        if (buffer && buffer != inlineStorage.Data()) {
+            AllocatorTraits::deallocate(allocator, buffer, count);
+        }
+    }
+
+    void DeallocateBuffer() {
+        Deallocate(items - frontSlack, frontSlack + capacity);
+    }
+
+    template <typename... Args>
+    void Construct(T* place, Args&&... args) {
+        AllocatorTraits::construct(allocator, place, std::forward<Args>(args)...);
+    }
+
+    void DestroyRange(T* first, T* last) {
+        if constexpr (BulkCopy) {
+            return;
+        }
+        for (; first != last; ++first) {
+            AllocatorTraits::destroy(allocator, first);
+        }
+    }
+
+    // Перевыделяет буфер под newCapacity элементов с newFront свободными
+    // ячейками перед ними, перенося size живых элементов
+    void Reallocate(IndexType newCapacity, IndexType newFront) {
+        if (newFront == 0) {
+            newCapacity = EffectiveCapacity(newCapacity);
+        }
+        T* newBuffer = AllocateBuffer(newFront, newCapacity);
+        T* newItems = newBuffer + newFront;
+        if constexpr (BulkCopy) {
+            CopyBytes(newItems, items, size);
+        } else {
+            IndexType constructed = 0;
+            try {
+                for (; constructed < size; ++constructed) {
+                    Construct(newItems + constructed, std::move_if_noexcept(items[constructed]));
+                }
+            } catch (...) {
+                DestroyRange(newItems, newItems + constructed);
+                Deallocate(newBuffer, newFront + newCapacity);
+                throw;
+            }
+            DestroyRange(items, items + size);
+        }
+        DeallocateBuffer();
+        items = newItems;
+        capacity = newCapacity;
+        frontSlack = newFront;
+    }
+
+    void Reallocate(IndexType newCapacity) {
+        Reallocate(newCapacity, frontSlack);
+    }
+
+    // Освобождает ячейку перед items; без запаса спереди он выделяется
+    // геометрически, как ёмкость сзади
+    void GrowFront() {
+        Reallocate(capacity, size < MinCapacity ? MinCapacity : size);
+    }
+
+    // Вставка сдвигом хвоста вправо
+    template <typename... Args>
+    void ShiftBackInsert(IndexType index, Args&&... args) {
+        if constexpr (BulkCopy) {
+            T value(std::forward<Args>(args)...);
+            if (size == capacity) {
+                Grow(size + 1);
+            }
+            MoveBytes(items + index + 1, items + index, size - index);
+            CopyBytes(items + index, &value, 1);
+            ++size;
+        } else {
+            EmplaceBack(std::forward<Args>(args)...);
+            std::rotate(items + index, items + size - 1, items + size);
+        }
+    }
+
+    // Вставка сдвигом первых index элементов влево, в запас спереди
+    template <typename... Args>
+    void ShiftFrontInsert(IndexType index, Args&&... args) {
+        // аргументы могут ссылаться на элементы массива, которые сдвинутся
+        T value(std::forward<Args>(args)...);
+        if (frontSlack == 0) {
+            GrowFront();
+        }
+        if constexpr (BulkCopy) {
+            MoveBytes(items - 1, items, index);
+            CopyBytes(items + index - 1, &value, 1);
+        } else if (index == 0) {
+            Construct(items - 1, std::move(value));
+        } else {
+            Construct(items - 1, std::move(items[0]));
+            std::move(items + 1, items + index, items);
+            items[index - 1] = std::move(value);
+        }
+        --items;
+        --frontSlack;
+        ++capacity;
+        ++size;
+    }
+
+    // Геометрический рост: amortized O(1) на добавление
+    void Grow(IndexType minCapacity) {
+        IndexType newCapacity = capacity < MinCapacity ? MinCapacity : capacity * 2;
+        if (newCapacity < minCapacity) {
+            newCapacity = minCapacity;
+        }
+        Reallocate(newCapacity);
+    }
+
+    // Копирует count элементов из source в сырой буфер items
+    void CopyConstruct(const T* source, IndexType count) {
+        if constexpr (BulkCopy) {
+            CopyBytes(items + size, source + size, count - size);
+            size = count;
+            return;
+        }
+        for (; size < count; ++size) {
+            Construct(items + size, source[size]);
+        }
+    }
+
+    // Заполняет сырые ячейки [size, newSize) копиями value
+    void FillConstruct(IndexType newSize, const T& value) {
+        if constexpr (BulkCopy) {
+            if (newSize > size) {
+                std::uninitialized_fill(items + size, items + newSize, value);
+                size = newSize;
+            }
+            return;
+        }
+        for (; size < newSize; ++size) {
+            Construct(items + size, value);
+        }
+    }
+
+    void CheckIndex(IndexType index) const {
+        if (BoundsCheckEnabled && (index < 0 || index >= size)) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+    }
+
+    void Release() {
+        DestroyRange(items, items + size);
+        DeallocateBuffer();
+        items = inlineStorage.Data();
+        size = 0;
+        capacity = InlineCapacity;
+        frontSlack = 0;
+    }
+
+    // Забирает содержимое other в пустой массив; элементы из встроенного
+    // буфера other приходится переносить по одному
+    void Steal(DynamicArray& other) noexcept(InlineCapacity == 0
+        || std::is_nothrow_move_constructible<T>::value) {
+        if (other.IsInline()) {
+            for (; size < other.size; ++size) {
+                Construct(items + size, std::move(other.items[size]));
+            }
+            other.Clear();
+            return;
+        }
+        items = other.items;
+        size = other.size;
+        capacity = other.capacity;
+        frontSlack = other.frontSlack;
+        other.items = other.inlineStorage.Data();
+        other.size = 0;
+        other.capacity = InlineCapacity;
+        other.frontSlack = 0;
+    }
 
 public:
-    DynamicArray() : items(nullptr), size(0), capacity(0) {}
+    DynamicArray()
+        : allocator(), items(inlineStorage.Data()), size(0), capacity(InlineCapacity), frontSlack(0) {}
+
+    explicit DynamicArray(const Allocator& allocator)
+        : allocator(allocator), items(inlineStorage.Data()), size(0), capacity(InlineCapacity), frontSlack(0) {}
 
-    DynamicArray(const T* items, int count) {
+    DynamicArray(const T* items, IndexType count, const Allocator& allocator = Allocator())
+        : allocator(allocator), items(inlineStorage.Data()), size(0), capacity(InlineCapacity), frontSlack(0) {
         if (count < 0) {
             throw InvalidSizeException("Count cannot be negative");
         }
-        this->size = count;
-        this->capacity = count;
-        this->items = new T[count];
-        for (int i = 0; i < count; i++) {
-            this->items[i] = items[i];
+        this->capacity = EffectiveCapacity(count);
+        this->items = Allocate(this->capacity);
+        try {
+            CopyConstruct(items, count);
+        } catch (...) {
+            Release();
+            throw;
         }
     }
-    DynamicArray(int size) : size(size), capacity(size) {
+    DynamicArray(IndexType size, const Allocator& allocator = Allocator())
+        : allocator(allocator), items(inlineStorage.Data()), size(0), capacity(InlineCapacity), frontSlack(0) {
         if (size < 0) {
             throw InvalidSizeException("Size cannot be negative");
         }
-        this->items = size > 0 ? new T[size]() : nullptr;
+        Resize(size);
     }
-    // from
-    DynamicArray(const DynamicArray<T>& other) : size(other.size), capacity(other.size) {
-        if (size == 0) {
-            items = nullptr;
-            return;
+    DynamicArray(IndexType size, const T& value, const Allocator& allocator = Allocator())
+        : allocator(allocator), items(inlineStorage.Data()), size(0), capacity(InlineCapacity), frontSlack(0) {
+        if (size < 0) {
+            throw InvalidSizeException("Size cannot be negative");
         }
-        items = new T[size];
-        for (int i = 0; i < size; ++i) {
-            items[i] = other.items[i];
+        Resize(size, value);
+    }
+    // from
+    DynamicArray(const DynamicArray& other)
+        : allocator(AllocatorTraits::select_on_container_copy_construction(other.allocator)),
+          items(inlineStorage.Data()), size(0), capacity(InlineCapacity), frontSlack(0) {
+        capacity = EffectiveCapacity(other.size);
+        items = Allocate(capacity);
+        try {
+            CopyConstruct(other.items, other.size);
+        } catch (...) {
+            Release();
+            throw;
         }
     }
 
-    DynamicArray& operator=(const DynamicArray<T>& other) {
+    DynamicArray(DynamicArray&& other) noexcept(InlineCapacity == 0
+        || std::is_nothrow_move_constructible<T>::value)
+        : allocator(std::move(other.allocator)), items(inlineStorage.Data()), size(0),
+          capacity(InlineCapacity), frontSlack(0) {
+        Steal(other);
+    }
+
+    DynamicArray& operator=(const DynamicArray& other) {
         if (this != &other) {
-            delete[] items;
-            size = other.size;
-            capacity = other.size;
-            if (size == 0) {
-                items = nullptr;
+            if (other.size > capacity) {
+                DynamicArray copy(other.items, other.size, allocator);
+                Release();
+                Steal(copy);
                 return *this;
             }
-            items = new T[size];
-            for (int i = 0; i < size; ++i) {
-                items[i] = other.items[i];
+            IndexType common = size < other.size ? size : other.size;
+            if constexpr (BulkCopy) {
+                CopyBytes(items, other.items, common);
+            } else {
+                for (IndexType i = 0; i < common; ++i) {
+                    items[i] = other.items[i];
+                }
+            }
+            if (size > other.size) {
+                DestroyRange(items + other.size, items + size);
+                size = other.size;
+            } else {
+                CopyConstruct(other.items, other.size);
+            }
+        }
+        return *this;
+    }
+
+    DynamicArray& operator=(DynamicArray&& other)
+        noexcept(AllocatorTraits::propagate_on_container_move_assignment::value
+            && (InlineCapacity == 0 || std::is_nothrow_move_constructible<T>::value)) {
+        if (this == &other) {
+            return *this;
+        }
+        if (AllocatorTraits::propagate_on_container_move_assignment::value) {
+            Release();
+            allocator = std::move(other.allocator);
+            Steal(other);
+        } else if (allocator == other.allocator) {
+            Release();
+            Steal(other);
+        } else {
+            // буфер чужого аллокатора забрать нельзя - переносим поэлементно
+            Clear();
+            Reserve(other.size);
+            for (; size < other.size; ++size) {
+                Construct(items + size, std::move(other.items[size]));
             }
+            other.Clear();
         }
         return *this;
     }
 
     ~DynamicArray() {
-        delete[] items;
+        Release();
     }
 
-    T Get(int index) const {
-        if (index < 0 || index >= size) {
-            throw IndexOutOfRangeException("Index out of range");
-        }
+    T Get(IndexType index) const {
+        CheckIndex(index);
         return items[index];
     }
 
-    int GetSize() const {
+    IndexType GetSize() const {
         return size;
     }
 
-    void Set(int index, const T& value) {
-        if (index < 0 || index >= size) {
-            throw IndexOutOfRangeException("Index out of range");
-        }
+    IndexType GetCapacity() const {
+        return capacity;
+    }
+
+    Allocator GetAllocator() const {
+        return allocator;
+    }
+
+    // Прямой доступ к буферу для внутренних циклов по заведомо
+    // корректному диапазону [0, GetSize())
+    T* Data() {
+        return items;
+    }
+
+    const T* Data() const {
+        return items;
+    }
+
+    void Set(IndexType index, const T& value) {
+        CheckIndex(index);
         items[index] = value;
     }
 
-    void Resize(int newSize) {
+    void Set(IndexType index, T&& value) {
+        CheckIndex(index);
+        items[index] = std::move(value);
+    }
+
+    void Reserve(IndexType newCapacity) {
+        if (newCapacity < 0) {
+            throw InvalidSizeException("Capacity cannot be negative");
+        }
+        if (newCapacity > capacity) {
+            Reallocate(newCapacity);
+        }
+    }
+
+    // Заполнение хвоста на месте, в том числе из нескольких потоков: после
+    // Reserve ячейки [size, size + count) строятся через ConstructAt в любом
+    // порядке и включаются в размер одним CommitConstructed(count). Пока
+    // размер не увеличен, построенное разрушает сам вызывающий через DestroyAt
+    template <typename... Args>
+    void ConstructAt(IndexType index, Args&&... args) {
+        Construct(items + index, std::forward<Args>(args)...);
+    }
+
+    void DestroyAt(IndexType index) {
+        DestroyRange(items + index, items + index + 1);
+    }
+
+    void CommitConstructed(IndexType count) {
+        size += count;
+    }
+
+    void ShrinkToFit() {
+        if ((capacity > size || frontSlack > 0) && !IsInline()) {
+            Reallocate(size, 0);
+        }
+    }
+
+    // Свободные ячейки перед первым элементом
+    IndexType GetFrontCapacity() const {
+        return frontSlack;
+    }
+
+    // Новые элементы value-инициализируются, поэтому требуется T()
+    void Resize(IndexType newSize) {
         if (newSize < 0) {
             throw InvalidSizeException("New size cannot be negative");
         }
-        if (newSize == 0) {
-            delete[] items;
-            items = nullptr;
-            size = 0;
-            capacity = 0;
-            return;
+        if (newSize > capacity) {
+            Reallocate(newSize);
         }
-        T* newItems = new T[newSize]();
-        int copySize = newSize < size ? newSize : size;
-        for (int i = 0; i < copySize; ++i) {
-            newItems[i] = items[i];
+        for (; size < newSize; ++size) {
+            Construct(items + size);
         }
-        delete[] items;
-        items = newItems;
+        DestroyRange(items + newSize, items + size);
         size = newSize;
-        capacity = newSize;
     }
 
-    T& operator[](int index) {
-        if (index < 0 || index >= size) {
-            throw IndexOutOfRangeException("Index out of range");
+    void Resize(IndexType newSize, const T& value) {
+        if (newSize < 0) {
+            throw InvalidSizeException("New size cannot be negative");
+        }
+        if (newSize > capacity) {
+            T copy = value;
+            Reallocate(newSize);
+            FillConstruct(newSize, copy);
+            return;
+        }
+        FillConstruct(newSize, value);
+        DestroyRange(items + newSize, items + size);
+        size = newSize;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size == capacity) {
+            // аргументы могут ссылаться на элементы этого же массива,
+            // поэтому элемент конструируется до переноса старого буфера
+            IndexType newCapacity = capacity < MinCapacity ? MinCapacity : capacity * 2;
+            T* newBuffer = AllocateBuffer(frontSlack, newCapacity);
+            T* newItems = newBuffer + frontSlack;
+            try {
+                Construct(newItems + size, std::forward<Args>(args)...);
+            } catch (...) {
+                Deallocate(newBuffer, frontSlack + newCapacity);
+                throw;
+            }
+            if constexpr (BulkCopy) {
+                CopyBytes(newItems, items, size);
+                DeallocateBuffer();
+                items = newItems;
+                capacity = newCapacity;
+                return items[size++];
+            }
+            IndexType moved = 0;
+            try {
+                for (; moved < size; ++moved) {
+                    Construct(newItems + moved, std::move_if_noexcept(items[moved]));
+                }
+            } catch (...) {
+                DestroyRange(newItems, newItems + moved);
+                DestroyRange(newItems + size, newItems + size + 1);
+                Deallocate(newBuffer, frontSlack + newCapacity);
+                throw;
+            }
+            DestroyRange(items, items + size);
+            DeallocateBuffer();
+            items = newItems;
+            capacity = newCapacity;
+            return items[size++];
+        }
+        Construct(items + size, std::forward<Args>(args)...);
+        return items[size++];
+    }
+
+    // Конструирует элемент на позиции index, сдвигая ту сторону, что короче.
+    // Встроенный буфер со свободным местом сдвигается только вправо, чтобы
+    // не уходить в кучу ради запаса спереди
+    template <typename... Args>
+    T& EmplaceAt(IndexType index, Args&&... args) {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        bool inlineRoom = IsInline() && size < capacity;
+        if (index < size - index && !inlineRoom) {
+            ShiftFrontInsert(index, std::forward<Args>(args)...);
+        } else {
+            ShiftBackInsert(index, std::forward<Args>(args)...);
         }
         return items[index];
     }
 
-    const T& operator[](int index) const {
-        if (index < 0 || index >= size) {
-            throw IndexOutOfRangeException("Index out of range");
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        return EmplaceAt(0, std::forward<Args>(args)...);
+    }
+
+    // Вставляет count элементов из values перед позицией index
+    void InsertRange(IndexType index, const T* values, IndexType count) {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        if (count < 0) {
+            throw InvalidSizeException("Count cannot be negative");
+        }
+        if (count == 0) {
+            return;
+        }
+        std::less<const T*> before;
+        if (!before(values, items) && before(values, items + size)) {
+            // источник лежит в этом же буфере и может сдвинуться или
+            // освободиться при росте - вставляем из копии
+            DynamicArray copy(values, count, allocator);
+            InsertRange(index, copy.items, count);
+            return;
         }
+        if (size + count > capacity) {
+            Grow(size + count);
+        }
+        if constexpr (BulkCopy) {
+            MoveBytes(items + index + count, items + index, size - index);
+            CopyBytes(items + index, values, count);
+            size += count;
+        } else {
+            IndexType oldSize = size;
+            try {
+                for (IndexType i = 0; i < count; ++i, ++size) {
+                    Construct(items + size, values[i]);
+                }
+            } catch (...) {
+                DestroyRange(items + oldSize, items + size);
+                size = oldSize;
+                throw;
+            }
+            std::rotate(items + index, items + oldSize, items + size);
+        }
+    }
+
+    // Удаляет count элементов начиная с index, сдвигая более короткую
+    // сторону: голова уезжает вправо и освободившиеся ячейки уходят в запас спереди
+    void EraseRange(IndexType index, IndexType count) {
+        if (index < 0 || count < 0 || index > size - count) {
+            throw IndexOutOfRangeException("Invalid erase range");
+        }
+        // иначе std::move ниже присвоил бы элементы самим себе
+        if (count == 0) {
+            return;
+        }
+        if (index < size - index - count && !IsInline()) {
+            if constexpr (BulkCopy) {
+                MoveBytes(items + count, items, index);
+            } else {
+                std::move_backward(items, items + index, items + index + count);
+                DestroyRange(items, items + count);
+            }
+            items += count;
+            frontSlack += count;
+            capacity -= count;
+            size -= count;
+            return;
+        }
+        if constexpr (BulkCopy) {
+            MoveBytes(items + index, items + index + count, size - index - count);
+        } else {
+            std::move(items + index + count, items + size, items + index);
+            DestroyRange(items + size - count, items + size);
+        }
+        size -= count;
+    }
+
+    void PopBack() {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        --size;
+        DestroyRange(items + size, items + size + 1);
+    }
+
+    // Запас спереди возвращается в ёмкость сзади
+    void Clear() {
+        DestroyRange(items, items + size);
+        size = 0;
+        items -= frontSlack;
+        capacity += frontSlack;
+        frontSlack = 0;
+    }
+
+    T& operator[](IndexType index) {
+        CheckIndex(index);
+        return items[index];
+    }
+
+    const T& operator[](IndexType index) const {
+        CheckIndex(index);
         return items[index];
     }
-};
\ No newline at end of file
+};
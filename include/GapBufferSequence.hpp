@@ -0,0 +1,347 @@
+#pragma once
+#include <utility>
+#include "SequenceOps.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+
+// Последовательность с разрывом (gap buffer) для правок вокруг курсора.
+// Элементы до разрыва лежат в front по порядку, элементы после него - в back
+// в обратном порядке, так что разрыв - это свободная ёмкость на концах обоих
+// массивов. Вставка и удаление у разрыва стоят O(1) амортизированно,
+// перенос разрыва - O(расстояния)
+template <typename T, typename Allocator = std::allocator<T>>
+class GapBufferSequence : public SequenceOps<T, GapBufferSequence<T, Allocator>> {
+private:
+    DynamicArray<T, Allocator> front;
+    DynamicArray<T, Allocator> back;
+
+    class GapBufferEnumerator : public IEnumerator<T> {
+    private:
+        const GapBufferSequence<T, Allocator>& sequence;
+        IndexType currentIndex;
+
+    public:
+        explicit GapBufferEnumerator(const GapBufferSequence<T, Allocator>& sequence)
+            : sequence(sequence), currentIndex(-1) {}
+
+        bool MoveNext() override {
+            if (currentIndex + 1 < sequence.GetLength()) {
+                currentIndex++;
+                return true;
+            }
+            return false;
+        }
+
+        const T& Current() const override {
+            if (currentIndex < 0 || currentIndex >= sequence.GetLength()) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return sequence.Cell(currentIndex);
+        }
+
+        void Reset() override {
+            currentIndex = -1;
+        }
+    };
+
+    const T& Cell(IndexType index) const {
+        IndexType gap = front.GetSize();
+        if (index < gap) {
+            return front.Data()[index];
+        }
+        return back.Data()[back.GetSize() - 1 - (index - gap)];
+    }
+
+    // Обход всех элементов по порядку без проверок индексов
+    template <typename Visitor>
+    void Visit(Visitor visit) const {
+        const T* data = front.Data();
+        for (IndexType i = 0; i < front.GetSize(); ++i) {
+            visit(data[i]);
+        }
+        data = back.Data();
+        for (IndexType i = back.GetSize() - 1; i >= 0; --i) {
+            visit(data[i]);
+        }
+    }
+
+    GapBufferSequence<T, Allocator>* CreateEmpty() const {
+        return new GapBufferSequence<T, Allocator>(front.GetAllocator());
+    }
+
+public:
+    GapBufferSequence() = default;
+    explicit GapBufferSequence(const Allocator& allocator) : front(allocator), back(allocator) {}
+    GapBufferSequence(const T* items, IndexType count, const Allocator& allocator = Allocator())
+        : front(items, count, allocator), back(allocator) {}
+
+    // Позиция разрыва: число элементов перед ним
+    IndexType GetGapPosition() const {
+        return front.GetSize();
+    }
+
+    void MoveGap(IndexType position) {
+        if (position < 0 || position > GetLength()) {
+            throw IndexOutOfRangeException("Invalid gap position");
+        }
+        while (front.GetSize() > position) {
+            back.PushBack(std::move(front.Data()[front.GetSize() - 1]));
+            front.PopBack();
+        }
+        while (front.GetSize() < position) {
+            front.PushBack(std::move(back.Data()[back.GetSize() - 1]));
+            back.PopBack();
+        }
+    }
+
+    T Get(IndexType index) const override {
+        return At(index);
+    }
+
+    T GetFirst() const override {
+        return FirstRef();
+    }
+
+    T GetLast() const override {
+        return LastRef();
+    }
+
+    const T& At(IndexType index) const override {
+        if (index < 0 || index >= GetLength()) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return Cell(index);
+    }
+
+    const T& FirstRef() const override {
+        if (GetLength() == 0) {
+            throw EmptySequenceException();
+        }
+        return Cell(0);
+    }
+
+    const T& LastRef() const override {
+        if (GetLength() == 0) {
+            throw EmptySequenceException();
+        }
+        return Cell(GetLength() - 1);
+    }
+
+    Option<T> TryGet(IndexType index) const override {
+        if (index < 0 || index >= GetLength()) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(index));
+    }
+
+    Option<T> TryGetFirst() const override {
+        if (GetLength() == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(0));
+    }
+
+    Option<T> TryGetLast() const override {
+        if (GetLength() == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(GetLength() - 1));
+    }
+
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const override {
+        if (startIndex < 0 || endIndex >= GetLength() || startIndex > endIndex) {
+            throw IndexOutOfRangeException("Invalid subsequence indices");
+        }
+        GapBufferSequence<T, Allocator>* result = CreateEmpty();
+        result->front.Reserve(endIndex - startIndex + 1);
+        for (IndexType i = startIndex; i <= endIndex; ++i) {
+            result->front.PushBack(Cell(i));
+        }
+        return result;
+    }
+
+    IndexType GetLength() const override {
+        return front.GetSize() + back.GetSize();
+    }
+
+    Allocator GetAllocator() const {
+        return front.GetAllocator();
+    }
+
+    // Ёмкость перед разрывом под count элементов
+    void Reserve(IndexType count) {
+        front.Reserve(count);
+    }
+
+    // Добавление в конец и в начало переносит разрыв к соответствующему краю
+    void Append(const T& item) override {
+        EmplaceAt(GetLength(), item);
+    }
+
+    void Append(T&& item) override {
+        EmplaceAt(GetLength(), std::move(item));
+    }
+
+    void Prepend(const T& item) override {
+        EmplaceAt(0, item);
+    }
+
+    void Prepend(T&& item) override {
+        EmplaceAt(0, std::move(item));
+    }
+
+    void InsertAt(const T& item, IndexType index) override {
+        EmplaceAt(index, item);
+    }
+
+    void InsertAt(T&& item, IndexType index) override {
+        EmplaceAt(index, std::move(item));
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        EmplaceAt(GetLength(), std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        EmplaceAt(0, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceAt(IndexType index, Args&&... args) {
+        if (index < 0 || index > GetLength()) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        // аргументы могут ссылаться на элемент самого буфера, который
+        // MoveGap переместит, поэтому значение строится заранее
+        T value(std::forward<Args>(args)...);
+        MoveGap(index);
+        front.EmplaceBack(std::move(value));
+    }
+
+    T RemoveAt(IndexType index) {
+        if (index < 0 || index >= GetLength()) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        MoveGap(index);
+        T value = std::move(back.Data()[back.GetSize() - 1]);
+        back.PopBack();
+        return value;
+    }
+
+    void Clear() {
+        front.Clear();
+        back.Clear();
+    }
+
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func.
+    // Результат выделяется сразу под всю длину, элементы строятся на месте
+    template <typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const {
+        using Result = MapResult<R, Func, T>;
+        using ResultAllocator = ReboundAllocator<Allocator, Result>;
+        auto* result = new GapBufferSequence<Result, ResultAllocator>(ResultAllocator(front.GetAllocator()));
+        result->Reserve(GetLength());
+        Visit([&](const T& item) { result->EmplaceBack(func(item)); });
+        return result;
+    }
+
+    template <typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const {
+        GapBufferSequence<T, Allocator>* result = CreateEmpty();
+        Visit([&](const T& item) {
+            if (predicate(item)) {
+                result->front.PushBack(item);
+            }
+        });
+        return result;
+    }
+
+    template <typename Func>
+    T Reduce(Func func, const T& initial) const {
+        T result = initial;
+        Visit([&](const T& item) { result = func(result, item); });
+        return result;
+    }
+
+    Sequence<T>* Slice(IndexType i, IndexType N, const Sequence<T>* s = nullptr) const override {
+        IndexType length = GetLength();
+
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+
+        GapBufferSequence<T, Allocator>* result = CreateEmpty();
+        result->front.Reserve(length - N + (s != nullptr ? s->GetLength() : 0));
+        for (IndexType j = 0; j < i; ++j) {
+            result->front.PushBack(Cell(j));
+        }
+        if (s != nullptr) {
+            for (IndexType j = 0; j < s->GetLength(); ++j) {
+                result->front.PushBack(s->At(j));
+            }
+        }
+        for (IndexType j = i + N; j < length; ++j) {
+            result->front.PushBack(Cell(j));
+        }
+        return result;
+    }
+
+    template <typename Func>
+    Sequence<T>* FlatMap(Func func) const {
+        GapBufferSequence<T, Allocator>* result = CreateEmpty();
+        Visit([&](const T& item) {
+            Sequence<T>* subseq = func(item);
+            for (IndexType j = 0; j < subseq->GetLength(); ++j) {
+                result->front.PushBack(subseq->At(j));
+            }
+            delete subseq;
+        });
+        return result;
+    }
+
+    template <typename Predicate>
+    Option<T> Find(Predicate predicate) const {
+        for (IndexType i = 0; i < GetLength(); ++i) {
+            if (predicate(Cell(i))) {
+                return Option<T>::Some(Cell(i));
+            }
+        }
+        return Option<T>::None();
+    }
+
+    template <typename Predicate>
+    std::pair<Sequence<T>*, Sequence<T>*> Split(Predicate predicate) const {
+        GapBufferSequence<T, Allocator>* matching = CreateEmpty();
+        GapBufferSequence<T, Allocator>* notMatching = CreateEmpty();
+        Visit([&](const T& item) {
+            if (predicate(item)) {
+                matching->front.PushBack(item);
+            } else {
+                notMatching->front.PushBack(item);
+            }
+        });
+        return std::make_pair(matching, notMatching);
+    }
+
+    Sequence<T>* Concat(const Sequence<T>* other) const override {
+        GapBufferSequence<T, Allocator>* result = CreateEmpty();
+        result->front.Reserve(GetLength() + other->GetLength());
+        Visit([&](const T& item) { result->front.PushBack(item); });
+        for (IndexType i = 0; i < other->GetLength(); ++i) {
+            result->front.PushBack(other->At(i));
+        }
+        return result;
+    }
+
+    IEnumerator<T>* GetEnumerator() const override {
+        return new GapBufferEnumerator(*this);
+    }
+};
@@ -11,10 +11,12 @@ private:
 
 public:
     ImmutableArraySequence() = default;
-    ImmutableArraySequence(const T* items, int count) : ArraySequence<T>(items, count) {}
+    ImmutableArraySequence(const T* items, IndexType count) : ArraySequence<T>(items, count) {}
     ImmutableArraySequence(const DynamicArray<T>& other) : ArraySequence<T>(other) {}
     ImmutableArraySequence(const ArraySequence<T>& other) : ArraySequence<T>(other) {}
     ImmutableArraySequence(const ImmutableArraySequence<T>& other) : ArraySequence<T>(other) {}
+    ImmutableArraySequence(DynamicArray<T>&& other) : ArraySequence<T>(std::move(other)) {}
+    ImmutableArraySequence(ImmutableArraySequence<T>&& other) noexcept : ArraySequence<T>(std::move(other)) {}
 
     void Append(const T& item) override {
         throw InvalidOperationException("Cannot modify immutable sequence");
@@ -24,65 +26,127 @@ public:
         throw InvalidOperationException("Cannot modify immutable sequence");
     }
 
-    void InsertAt(const T& item, int index) override {
+    void InsertAt(const T& item, IndexType index) override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    void Append(T&& item) override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    void Prepend(T&& item) override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    void InsertAt(T&& item, IndexType index) override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    template <typename... Args>
+    void EmplaceAt(IndexType index, Args&&... args) {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    T RemoveLast() override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    void InsertRange(IndexType index, const T* items, IndexType count) {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    void RemoveRange(IndexType index, IndexType count) {
         throw InvalidOperationException("Cannot modify immutable sequence");
     }
 
     ImmutableArraySequence<T>* AppendNew(const T& item) const {
-        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>(*this);
-        result->array.Resize(array.GetSize() + 1);
-        result->array.Set(array.GetSize(), item);
+        const T* data = array.Data();
+        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
+        result->array.Reserve(array.GetSize() + 1);
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            result->array.PushBack(data[i]);
+        }
+        result->array.PushBack(item);
         return result;
     }
 
     ImmutableArraySequence<T>* PrependNew(const T& item) const {
+        const T* data = array.Data();
         ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        result->array.Resize(array.GetSize() + 1);
-        result->array.Set(0, item);
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result->array.Set(i + 1, array.Get(i));
+        result->array.Reserve(array.GetSize() + 1);
+        result->array.PushBack(item);
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            result->array.PushBack(data[i]);
         }
         return result;
     }
 
-    ImmutableArraySequence<T>* InsertAtNew(const T& item, int index) const {
+    ImmutableArraySequence<T>* InsertAtNew(const T& item, IndexType index) const {
+        const T* data = array.Data();
         if (index < 0 || index > array.GetSize()) {
             throw IndexOutOfRangeException("Invalid insert index");
         }
         ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        result->array.Resize(array.GetSize() + 1);
+        result->array.Reserve(array.GetSize() + 1);
         
-        for (int i = 0; i < index; ++i) {
-            result->array.Set(i, array.Get(i));
+        for (IndexType i = 0; i < index; ++i) {
+            result->array.PushBack(data[i]);
         }
-        result->array.Set(index, item);
-        for (int i = index; i < array.GetSize(); ++i) {
-            result->array.Set(i + 1, array.Get(i));
+        result->array.PushBack(item);
+        for (IndexType i = index; i < array.GetSize(); ++i) {
+            result->array.PushBack(data[i]);
         }
         return result;
     }
 
     Sequence<T>* Map(T (*func)(const T&)) const override {
-        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(func(array.Get(i))));
-        }
-        return result;
+        return Map<T>(func);
+    }
+
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func.
+    // Буфер результата выделяется сразу под всю длину
+    template <typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const {
+        using Result = MapResult<R, Func, T>;
+        const T* data = array.Data();
+        DynamicArray<Result> mapped;
+        mapped.Reserve(array.GetSize());
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            mapped.EmplaceBack(func(data[i]));
+        }
+        return new ImmutableArraySequence<Result>(std::move(mapped));
     }
 
     Sequence<T>* Where(bool (*predicate)(const T&)) const override {
+        return Where<bool (*)(const T&)>(predicate);
+    }
+
+    template <typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const {
+        const T* data = array.Data();
         ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        for (int i = 0; i < array.GetSize(); ++i) {
-            T current = array.Get(i);
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            const T& current = data[i];
             if (predicate(current)) {
-                result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(current));
+                result->array.PushBack(current);
             }
         }
         return result;
     }
 
-    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
-        int length = array.GetSize();
+    Sequence<T>* Slice(IndexType i, IndexType N, const Sequence<T>* s = nullptr) const override {
+        const T* data = array.Data();
+        IndexType length = array.GetSize();
 
         if (i < 0) {
             i = length + i;
@@ -96,29 +160,35 @@ public:
         
         ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
         
-        for (int j = 0; j < i; ++j) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(array.Get(j)));
+        for (IndexType j = 0; j < i; ++j) {
+            result->array.PushBack(data[j]);
         }
         
         if (s != nullptr) {
-            for (int j = 0; j < s->GetLength(); ++j) {
-                result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(s->Get(j)));
+            for (IndexType j = 0; j < s->GetLength(); ++j) {
+                result->array.PushBack(s->At(j));
             }
         }
         
-        for (int j = i + N; j < length; ++j) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(array.Get(j)));
+        for (IndexType j = i + N; j < length; ++j) {
+            result->array.PushBack(data[j]);
         }
         
         return result;
     }
 
     Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
+        return FlatMap<Sequence<T>* (*)(const T&)>(func);
+    }
+
+    template <typename Func>
+    Sequence<T>* FlatMap(Func func) const {
+        const T* data = array.Data();
         ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        for (int i = 0; i < array.GetSize(); ++i) {
-            Sequence<T>* subseq = func(array.Get(i));
-            for (int j = 0; j < subseq->GetLength(); ++j) {
-                result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(subseq->Get(j)));
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            Sequence<T>* subseq = func(data[i]);
+            for (IndexType j = 0; j < subseq->GetLength(); ++j) {
+                result->array.PushBack(subseq->At(j));
             }
             delete subseq;
         }
@@ -126,28 +196,36 @@ public:
     }
 
     std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
+        return Split<bool (*)(const T&)>(predicate);
+    }
+
+    template <typename Predicate>
+    std::pair<Sequence<T>*, Sequence<T>*> Split(Predicate predicate) const {
+        const T* data = array.Data();
         auto* trueSeq = new ImmutableArraySequence<T>();
         auto* falseSeq = new ImmutableArraySequence<T>();
         
-        for (int i = 0; i < array.GetSize(); i++) {
-            if (predicate(array.Get(i))) {
-                trueSeq = static_cast<ImmutableArraySequence<T>*>(trueSeq->AppendNew(array.Get(i)));
+        for (IndexType i = 0; i < array.GetSize(); i++) {
+            if (predicate(data[i])) {
+                trueSeq->array.PushBack(data[i]);
             } else {
-                falseSeq = static_cast<ImmutableArraySequence<T>*>(falseSeq->AppendNew(array.Get(i)));
+                falseSeq->array.PushBack(data[i]);
             }
         }
         return std::make_pair(trueSeq, falseSeq);
     }
 
     Sequence<T>* Concat(const Sequence<T>* other) const override {
+        const T* data = array.Data();
         ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
+        result->array.Reserve(array.GetSize() + other->GetLength());
         
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(array.Get(i)));
+        for (IndexType i = 0; i < array.GetSize(); ++i) {
+            result->array.PushBack(data[i]);
         }
     
-        for (int i = 0; i < other->GetLength(); ++i) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(other->Get(i)));
+        for (IndexType i = 0; i < other->GetLength(); ++i) {
+            result->array.PushBack(other->At(i));
         }
         
         return result;
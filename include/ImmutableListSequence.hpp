@@ -4,17 +4,29 @@
 #include "LinkedList.hpp"
 #include "ListSequence.hpp"
 
+// Неизменяемость - про содержимое: Get/At по индексу всё равно двигают палец
+// LinkedList, и без внешней синхронизации делить объект между потоками
+// можно только для обхода перечислителем или курсорами
 template <typename T>
 class ImmutableListSequence : public ListSequence<T> {
 private:
     using ListSequence<T>::list;
 
+protected:
+    bool CanDonate() const override {
+        return false;
+    }
+
 public:
+    using typename ListSequence<T>::Cursor;
+
     ImmutableListSequence() = default;
-    ImmutableListSequence(const T* items, int count) : ListSequence<T>(items, count) {}
+    ImmutableListSequence(const T* items, IndexType count) : ListSequence<T>(items, count) {}
     ImmutableListSequence(const LinkedList<T>& other) : ListSequence<T>(other) {}
     ImmutableListSequence(const ListSequence<T>& other) : ListSequence<T>(other) {}
     ImmutableListSequence(const ImmutableListSequence<T>& other) : ListSequence<T>(other) {}
+    ImmutableListSequence(LinkedList<T>&& other) : ListSequence<T>(std::move(other)) {}
+    ImmutableListSequence(ImmutableListSequence<T>&& other) noexcept : ListSequence<T>(std::move(other)) {}
 
     void Append(const T& item) override {
         throw InvalidOperationException("Cannot modify immutable sequence");
@@ -24,7 +36,46 @@ public:
         throw InvalidOperationException("Cannot modify immutable sequence");
     }
 
-    void InsertAt(const T& item, int index) override {
+    void InsertAt(const T& item, IndexType index) override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    void Append(T&& item) override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    void Prepend(T&& item) override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    void InsertAt(T&& item, IndexType index) override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    template <typename... Args>
+    void EmplaceAt(IndexType index, Args&&... args) {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    T RemoveFirst() override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    T RemoveLast() override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    void ConcatInPlace(ListSequence<T>& other) override {
         throw InvalidOperationException("Cannot modify immutable sequence");
     }
 
@@ -40,7 +91,7 @@ public:
         return result;
     }
 
-    ImmutableListSequence<T>* InsertAtNew(const T& item, int index) const {
+    ImmutableListSequence<T>* InsertAtNew(const T& item, IndexType index) const {
         if (index < 0 || index > list.GetSize()) {
             throw IndexOutOfRangeException("Invalid insert index");
         }
@@ -50,26 +101,41 @@ public:
     }
 
     Sequence<T>* Map(T (*func)(const T&)) const override {
-        ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(func(list.Get(i))));
+        return Map<T>(func);
+    }
+
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func.
+    // В отличие от массивов, узлы результата не выделяются заранее под всю
+    // длину: один большой блок слаба оказался не быстрее обычного роста
+    // блоками. Значение func перемещается в узел
+    template <typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const {
+        using Result = MapResult<R, Func, T>;
+        LinkedList<Result> mapped(ReboundAllocator<std::allocator<T>, Result>(list.GetAllocator()));
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            mapped.EmplaceBack(func(current.Get()));
         }
-        return result;
+        return new ImmutableListSequence<Result>(std::move(mapped));
     }
 
     Sequence<T>* Where(bool (*predicate)(const T&)) const override {
+        return Where<bool (*)(const T&)>(predicate);
+    }
+
+    template <typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const {
         ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            T current = list.Get(i);
-            if (predicate(current)) {
-                result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(current));
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            const T& item = current.Get();
+            if (predicate(item)) {
+                result->list.Append(item);
             }
         }
         return result;
     }
 
-    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
-        int length = list.GetSize();
+    Sequence<T>* Slice(IndexType i, IndexType N, const Sequence<T>* s = nullptr) const override {
+        IndexType length = list.GetSize();
         
         if (i < 0) {
             i = length + i;
@@ -83,45 +149,55 @@ public:
         
         ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
         
-        for (int j = 0; j < i; ++j) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(list.Get(j)));
+        Cursor current = list.First();
+        for (IndexType j = 0; j < i; ++j, current.MoveNext()) {
+            result->list.Append(current.Get());
         }
         
         if (s != nullptr) {
-            for (int j = 0; j < s->GetLength(); ++j) {
-                result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(s->Get(j)));
-            }
+            ListSequence<T>::AppendAll(result->list, s);
         }
 
-        for (int j = i + N; j < length; ++j) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(list.Get(j)));
+        for (IndexType j = 0; j < N; ++j) {
+            current.MoveNext();
+        }
+        for (; current.IsValid(); current.MoveNext()) {
+            result->list.Append(current.Get());
         }
         
         return result;
     }
 
     Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
+        return FlatMap<Sequence<T>* (*)(const T&)>(func);
+    }
+
+    template <typename Func>
+    Sequence<T>* FlatMap(Func func) const {
         ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            Sequence<T>* subseq = func(list.Get(i));
-            for (int j = 0; j < subseq->GetLength(); ++j) {
-                result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(subseq->Get(j)));
-            }
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            Sequence<T>* subseq = func(current.Get());
+            ListSequence<T>::AppendAll(result->list, subseq);
             delete subseq;
         }
         return result;
     }
 
     std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
+        return Split<bool (*)(const T&)>(predicate);
+    }
+
+    template <typename Predicate>
+    std::pair<Sequence<T>*, Sequence<T>*> Split(Predicate predicate) const {
         ImmutableListSequence<T>* matching = new ImmutableListSequence<T>();
         ImmutableListSequence<T>* notMatching = new ImmutableListSequence<T>();
 
-        for (int i = 0; i < list.GetSize(); ++i) {
-            T current = list.Get(i);
-            if (predicate(current)) {
-                matching = static_cast<ImmutableListSequence<T>*>(matching->AppendNew(current));
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            const T& item = current.Get();
+            if (predicate(item)) {
+                matching->list.Append(item);
             } else {
-                notMatching = static_cast<ImmutableListSequence<T>*>(notMatching->AppendNew(current));
+                notMatching->list.Append(item);
             }
         }
 
@@ -129,16 +205,8 @@ public:
     }
 
     Sequence<T>* Concat(const Sequence<T>* other) const override {
-        ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
-        
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(list.Get(i)));
-        }
-        
-        for (int i = 0; i < other->GetLength(); ++i) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(other->Get(i)));
-        }
-        
+        ImmutableListSequence<T>* result = new ImmutableListSequence<T>(list);
+        ListSequence<T>::AppendAll(result->list, other);
         return result;
     }
 };
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+
+// Тип размеров и индексов всех контейнеров. По умолчанию знаковый
+// 64-битный, чтобы последовательности не упирались в 2^31 элементов;
+// сборка с -DSEQUENCE_INDEX_TYPE=int возвращает прежнее поведение
+#ifdef SEQUENCE_INDEX_TYPE
+using IndexType = SEQUENCE_INDEX_TYPE;
+#else
+using IndexType = std::ptrdiff_t;
+#endif
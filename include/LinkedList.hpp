@@ -1,31 +1,184 @@
 #pragma once
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include "Exceptions.hpp"
+#include "Index.hpp"
+#include "NodeSlab.hpp"
 
 template <typename T>
 struct Node {
     T data;
     Node* next;
-    Node(const T& item) : data(item), next(nullptr) {}
+    Node* prev;
+    template <typename... Args>
+    explicit Node(Args&&... args) : data(std::forward<Args>(args)...), next(nullptr), prev(nullptr) {}
 };
 
-template <typename T>
+// Потокобезопасность: константные Get и At передвигают палец, то есть
+// пишут в объект, поэтому одновременное чтение одного списка по индексу из
+// нескольких потоков - гонка данных. Курсоры (First/Last) палец не трогают,
+// и параллельно читать список можно только через них
+template <typename T, typename Allocator = std::allocator<T>>
 class LinkedList {
 private:
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node<T>>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    // Узлы берутся из собственного слаба списка, а не по одному из аллокатора
+    NodeSlab<Node<T>, NodeAllocator> nodes;
     Node<T>* head;
-    int size;
+    // последний узел: добавление в конец и чтение последнего за O(1)
+    Node<T>* tail;
+    IndexType size;
+    // Палец: последний найденный по индексу узел. Доступ к соседним
+    // индексам продолжает обход от него; любая перестройка связей его сбрасывает.
+    // mutable, поэтому константный доступ по индексу не потокобезопасен
+    mutable Node<T>* finger;
+    mutable IndexType fingerIndex;
+
+    template <typename... Args>
+    Node<T>* CreateNode(Args&&... args) {
+        return nodes.Create(std::forward<Args>(args)...);
+    }
+
+    void DestroyNode(Node<T>* node) {
+        nodes.Destroy(node);
+    }
+
+    static IndexType Distance(IndexType from, IndexType to) {
+        return from < to ? to - from : from - to;
+    }
+
+    // Узел с заданным индексом; обход начинается с ближайшего из
+    // головы, хвоста и пальца
+    Node<T>* NodeAt(IndexType index) const {
+        Node<T>* current = head;
+        IndexType position = 0;
+        if (size - 1 - index < index) {
+            current = tail;
+            position = size - 1;
+        }
+        if (finger && Distance(fingerIndex, index) < Distance(position, index)) {
+            current = finger;
+            position = fingerIndex;
+        }
+        for (; position < index; ++position) {
+            current = current->next;
+        }
+        for (; position > index; --position) {
+            current = current->prev;
+        }
+        finger = current;
+        fingerIndex = index;
+        return current;
+    }
+
+    // Вставляет новый узел после after; nullptr означает вставку в начало
+    void Link(Node<T>* after, Node<T>* newNode) noexcept {
+        finger = nullptr;
+        newNode->prev = after;
+        newNode->next = after ? after->next : head;
+        if (newNode->next) {
+            newNode->next->prev = newNode;
+        } else {
+            tail = newNode;
+        }
+        if (after) {
+            after->next = newNode;
+        } else {
+            head = newNode;
+        }
+        ++size;
+    }
+
+    void Unlink(Node<T>* node) noexcept {
+        finger = nullptr;
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            head = node->next;
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        } else {
+            tail = node->prev;
+        }
+        --size;
+    }
+
+    T Extract(Node<T>* node) {
+        T value = std::move(node->data);
+        Unlink(node);
+        DestroyNode(node);
+        return value;
+    }
+
+    void Steal(LinkedList& other) noexcept {
+        head = other.head;
+        tail = other.tail;
+        size = other.size;
+        finger = other.finger;
+        fingerIndex = other.fingerIndex;
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.size = 0;
+        other.finger = nullptr;
+    }
 
 public:
-    LinkedList() : head(nullptr), size(0) {}
-    LinkedList(const T* items, int count) : head(nullptr), size(0) {
+    // Позиция в списке; остаётся действительной, пока её узел не удалён.
+    // Недействительный курсор в InsertAfter означает позицию перед первым
+    class Cursor {
+    private:
+        friend class LinkedList;
+        Node<T>* node;
+
+        explicit Cursor(Node<T>* node) : node(node) {}
+
+    public:
+        Cursor() : node(nullptr) {}
+
+        bool IsValid() const {
+            return node != nullptr;
+        }
+
+        const T& Get() const {
+            if (!node) {
+                throw InvalidStateException("Cursor is not in a valid position");
+            }
+            return node->data;
+        }
+
+        void MoveNext() {
+            if (node) {
+                node = node->next;
+            }
+        }
+
+        void MovePrev() {
+            if (node) {
+                node = node->prev;
+            }
+        }
+    };
+
+    LinkedList() : nodes(), head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {}
+    explicit LinkedList(const Allocator& allocator)
+        : nodes(NodeAllocator(allocator)), head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {}
+    LinkedList(const T* items, IndexType count, const Allocator& allocator = Allocator())
+        : nodes(NodeAllocator(allocator)), head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {
         if (count < 0) {
             throw InvalidSizeException("Count cannot be negative");
         }
-        for (int i = 0; i < count; i++) {
+        for (IndexType i = 0; i < count; i++) {
             Append(items[i]);
         }
     }
     // from
-    LinkedList(const LinkedList<T>& other) : head(nullptr), size(0) {
+    LinkedList(const LinkedList& other)
+        : nodes(NodeTraits::select_on_container_copy_construction(other.nodes.GetAllocator())),
+          head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {
         Node<T>* current = other.head;
         while (current) {
             Append(current->data);
@@ -33,7 +186,12 @@ public:
         }
     }
 
-    LinkedList& operator=(const LinkedList<T>& other) {
+    LinkedList(LinkedList&& other) noexcept
+        : nodes(std::move(other.nodes)), head(nullptr), tail(nullptr), size(0), finger(nullptr), fingerIndex(0) {
+        Steal(other);
+    }
+
+    LinkedList& operator=(const LinkedList& other) {
         if (this != &other) {
             Clear();
             Node<T>* current = other.head;
@@ -45,88 +203,248 @@ public:
         return *this;
     }
 
+    LinkedList& operator=(LinkedList&& other)
+        noexcept(NodeTraits::propagate_on_container_move_assignment::value) {
+        if (this == &other) {
+            return *this;
+        }
+        Clear();
+        if (NodeTraits::propagate_on_container_move_assignment::value
+            || nodes.GetAllocator() == other.nodes.GetAllocator()) {
+            // слаб переходит целиком вместе с узлами
+            nodes = std::move(other.nodes);
+            Steal(other);
+        } else {
+            // узлы чужого аллокатора забрать нельзя - переносим поэлементно
+            Node<T>* current = other.head;
+            while (current) {
+                Append(std::move(current->data));
+                current = current->next;
+            }
+            other.Clear();
+        }
+        return *this;
+    }
+
+    Allocator GetAllocator() const {
+        return Allocator(nodes.GetAllocator());
+    }
+
     ~LinkedList() {
         Clear();
     }
 
-    T Get(int index) const {
+    T Get(IndexType index) const {
+        return At(index);
+    }
+
+    T GetFirst() const {
+        return FirstRef();
+    }
+
+    T GetLast() const {
+        return LastRef();
+    }
+
+    const T& At(IndexType index) const {
         if (index < 0 || index >= size) {
             throw IndexOutOfRangeException("Index out of range");
         }
-        Node<T>* current = head;
-        for (int i = 0; i < index; ++i) {
-            current = current->next;
-        }
-        return current->data;
+        return NodeAt(index)->data;
     }
 
-    T GetFirst() const {
+    const T& FirstRef() const {
         if (size == 0) {
             throw EmptySequenceException();
         }
         return head->data;
     }
 
-    T GetLast() const {
+    const T& LastRef() const {
         if (size == 0) {
             throw EmptySequenceException();
         }
-        Node<T>* current = head;
-        while (current->next) {
-            current = current->next;
-        }
-        return current->data;
+        return tail->data;
     }
 
-    int GetSize() const {
+    IndexType GetSize() const {
         return size;
     }
 
     void Append(const T& item) {
-        Node<T>* newNode = new Node<T>(item);
-        if (!head) {
-            head = newNode;
-        } else {
-            Node<T>* current = head;
-            while (current->next) {
-                current = current->next;
-            }
-            current->next = newNode;
-        }
-        ++size;
+        EmplaceBack(item);
+    }
+
+    void Append(T&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        Node<T>* newNode = CreateNode(std::forward<Args>(args)...);
+        Link(tail, newNode);
+        return newNode->data;
     }
 
     void Prepend(const T& item) {
-        Node<T>* newNode = new Node<T>(item);
-        newNode->next = head;
-        head = newNode;
-        ++size;
+        EmplaceFront(item);
     }
 
-    void InsertAt(const T& item, int index) {
+    void Prepend(T&& item) {
+        EmplaceFront(std::move(item));
+    }
+
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        Node<T>* newNode = CreateNode(std::forward<Args>(args)...);
+        Link(nullptr, newNode);
+        return newNode->data;
+    }
+
+    void InsertAt(const T& item, IndexType index) {
+        EmplaceAt(index, item);
+    }
+
+    void InsertAt(T&& item, IndexType index) {
+        EmplaceAt(index, std::move(item));
+    }
+
+    template <typename... Args>
+    T& EmplaceAt(IndexType index, Args&&... args) {
         if (index < 0 || index > size) {
             throw IndexOutOfRangeException("Invalid insert index");
         }
         if (index == 0) {
-            Prepend(item);
+            return EmplaceFront(std::forward<Args>(args)...);
+        }
+        if (index == size) {
+            return EmplaceBack(std::forward<Args>(args)...);
+        }
+        Node<T>* after = NodeAt(index - 1);
+        Node<T>* newNode = CreateNode(std::forward<Args>(args)...);
+        Link(after, newNode);
+        // вставка по соседним индексам продолжит путь от нового узла
+        finger = newNode;
+        fingerIndex = index;
+        return newNode->data;
+    }
+
+    T RemoveFirst() {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        return Extract(head);
+    }
+
+    T RemoveLast() {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        return Extract(tail);
+    }
+
+    Cursor First() const {
+        return Cursor(head);
+    }
+
+    Cursor Last() const {
+        return Cursor(tail);
+    }
+
+    Cursor InsertAfter(Cursor position, const T& item) {
+        return EmplaceAfter(position, item);
+    }
+
+    Cursor InsertAfter(Cursor position, T&& item) {
+        return EmplaceAfter(position, std::move(item));
+    }
+
+    template <typename... Args>
+    Cursor EmplaceAfter(Cursor position, Args&&... args) {
+        Node<T>* newNode = CreateNode(std::forward<Args>(args)...);
+        Link(position.node, newNode);
+        return Cursor(newNode);
+    }
+
+    // Переносит все узлы other после position (недействительный курсор -
+    // в начало) перелинковкой, без копирования; other остаётся пустым.
+    // При разных аллокаторах элементы переносятся по одному
+    void Splice(Cursor position, LinkedList& other) {
+        if (this == &other || other.size == 0) {
             return;
         }
-        Node<T>* newNode = new Node<T>(item);
-        Node<T>* current = head;
-        for (int i = 0; i < index - 1; ++i) {
-            current = current->next;
+        if (!(nodes.GetAllocator() == other.nodes.GetAllocator())) {
+            for (Node<T>* current = other.head; current; current = current->next) {
+                position = EmplaceAfter(position, std::move(current->data));
+            }
+            other.Clear();
+            return;
         }
-        newNode->next = current->next;
-        current->next = newNode;
-        ++size;
+        Node<T>* after = position.node;
+        Node<T>* before = after ? after->next : head;
+        other.head->prev = after;
+        other.tail->next = before;
+        if (after) {
+            after->next = other.head;
+        } else {
+            head = other.head;
+        }
+        if (before) {
+            before->prev = other.tail;
+        } else {
+            tail = other.tail;
+        }
+        size += other.size;
+        finger = nullptr;
+        nodes.Adopt(other.nodes);
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.size = 0;
+        other.finger = nullptr;
     }
 
+    void AppendList(LinkedList& other) {
+        Splice(Last(), other);
+    }
+
+    // Удаляет элемент под курсором и возвращает курсор на следующий
+    Cursor Erase(Cursor position) {
+        if (!position.node) {
+            throw InvalidStateException("Cursor is not in a valid position");
+        }
+        Node<T>* next = position.node->next;
+        Unlink(position.node);
+        DestroyNode(position.node);
+        return Cursor(next);
+    }
+
+    // Удаляет элемент под курсором и возвращает его значение
+    T Extract(Cursor position) {
+        if (!position.node) {
+            throw InvalidStateException("Cursor is not in a valid position");
+        }
+        return Extract(position.node);
+    }
+
+    // Выделяет место под count следующих узлов одним блоком
+    void Reserve(IndexType count) {
+        nodes.Reserve(count);
+    }
+
+    // Память возвращается поблочно; для тривиально разрушаемых T
+    // обходить узлы не нужно вовсе
     void Clear() {
-        while (head) {
-            Node<T>* temp = head;
-            head = head->next;
-            delete temp;
+        if (!std::is_trivially_destructible<T>::value) {
+            while (head) {
+                Node<T>* temp = head;
+                head = head->next;
+                DestroyNode(temp);
+            }
         }
+        head = nullptr;
+        tail = nullptr;
         size = 0;
+        finger = nullptr;
+        nodes.Release();
     }
-};
\ No newline at end of file
+};
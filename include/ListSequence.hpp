@@ -1,65 +1,95 @@
 #pragma once
 #include <utility>
-#include "Sequence.hpp"
+#include "SequenceOps.hpp"
 #include "LinkedList.hpp"
+#include "UnrolledLinkedList.hpp"
 #include "Exceptions.hpp"
 
-template <typename T>
-class ListSequence : public Sequence<T> {
+// List - хранилище элементов: LinkedList (по умолчанию) или UnrolledLinkedList.
+// С LinkedList константные Get/At двигают палец списка, поэтому читать одну
+// последовательность по индексу из нескольких потоков нельзя; HOF,
+// перечислитель и курсоры идут по узлам и палец не меняют
+template <typename T, typename Allocator = std::allocator<T>,
+          template <typename, typename> class List = LinkedList>
+class ListSequence : public SequenceOps<T, ListSequence<T, Allocator, List>> {
+public:
+    using Cursor = typename List<T, Allocator>::Cursor;
+
 protected:
-    LinkedList<T> list;
+    List<T, Allocator> list;
+
+    // Дописывает в target все элементы source за один проход его перечислителя
+    static void AppendAll(List<T, Allocator>& target, const Sequence<T>* source) {
+        IEnumerator<T>* enumerator = source->GetEnumerator();
+        while (enumerator->MoveNext()) {
+            target.Append(enumerator->Current());
+        }
+        delete enumerator;
+    }
+
+    // Можно ли забрать узлы этой последовательности в ConcatInPlace
+    virtual bool CanDonate() const {
+        return true;
+    }
 
 private:
     class LinkedListEnumerator : public IEnumerator<T> {
     private:
-        const LinkedList<T>& list;
-        int currentIndex;
-        T currentValue;
+        const List<T, Allocator>& list;
+        Cursor current;
         bool isBeforeFirst;
 
     public:
-        explicit LinkedListEnumerator(const LinkedList<T>& list) 
-            : list(list), currentIndex(-1), isBeforeFirst(true) {}
+        explicit LinkedListEnumerator(const List<T, Allocator>& list) 
+            : list(list), current(), isBeforeFirst(true) {}
 
         bool MoveNext() override {
-            if (currentIndex + 1 < list.GetSize()) {
-                currentIndex++;
-                currentValue = list.Get(currentIndex);
+            if (isBeforeFirst) {
+                current = list.First();
                 isBeforeFirst = false;
-                return true;
+            } else {
+                current.MoveNext();
             }
-            return false;
+            return current.IsValid();
         }
 
         const T& Current() const override {
-            if (isBeforeFirst || currentIndex >= list.GetSize()) {
+            if (!current.IsValid()) {
                 throw InvalidStateException("Enumerator is not in a valid position");
             }
-            return currentValue;
+            return current.Get();
         }
 
         void Reset() override {
-            currentIndex = -1;
+            current = Cursor();
             isBeforeFirst = true;
         }
     };
 
 public:
     ListSequence() = default;
-    ListSequence(T* items, int count) : list(items, count) {}
-    ListSequence(const T* items, int count) {
-        T* nonConstItems = new T[count];
-        for (int i = 0; i < count; ++i) {
-            nonConstItems[i] = items[i];
-        }
-        list = LinkedList<T>(nonConstItems, count);
-        delete[] nonConstItems;
-    }
-    ListSequence(const LinkedList<T>& other) : list(other) {}
+    explicit ListSequence(const Allocator& allocator) : list(allocator) {}
+    ListSequence(T* items, IndexType count, const Allocator& allocator = Allocator())
+        : list(items, count, allocator) {}
+    ListSequence(const T* items, IndexType count, const Allocator& allocator = Allocator())
+        : list(items, count, allocator) {}
+    ListSequence(const List<T, Allocator>& other) : list(other) {}
+    ListSequence(List<T, Allocator>&& other) : list(std::move(other)) {}
     // from
-    ListSequence(const ListSequence<T>& other) : list(other.list) {}
+    ListSequence(const ListSequence<T, Allocator, List>& other) : list(other.list) {}
+    ListSequence(ListSequence<T, Allocator, List>&& other) noexcept : list(std::move(other.list)) {}
+
+    ListSequence& operator=(const ListSequence<T, Allocator, List>& other) {
+        list = other.list;
+        return *this;
+    }
 
-    T Get(int index) const override {
+    ListSequence& operator=(ListSequence<T, Allocator, List>&& other) noexcept {
+        list = std::move(other.list);
+        return *this;
+    }
+
+    T Get(IndexType index) const override {
         return list.Get(index);
     }
 
@@ -71,48 +101,81 @@ public:
         return list.GetLast();
     }
 
-    Option<T> TryGet(int index) const override {
-        try {
-            return Option<T>::Some(list.Get(index));
-        } catch (const IndexOutOfRangeException&) {
+    const T& At(IndexType index) const override {
+        return list.At(index);
+    }
+
+    const T& FirstRef() const override {
+        return list.FirstRef();
+    }
+
+    const T& LastRef() const override {
+        return list.LastRef();
+    }
+
+    Option<T> TryGet(IndexType index) const override {
+        if (index < 0 || index >= list.GetSize()) {
             return Option<T>::None();
         }
+        return Option<T>::Some(list.At(index));
     }
 
     Option<T> TryGetFirst() const override {
-        try {
-            return Option<T>::Some(list.GetFirst());
-        } catch (const EmptySequenceException&) {
+        if (list.GetSize() == 0) {
             return Option<T>::None();
         }
+        return Option<T>::Some(list.FirstRef());
     }
 
     Option<T> TryGetLast() const override {
-        try {
-            return Option<T>::Some(list.GetLast());
-        } catch (const EmptySequenceException&) {
+        if (list.GetSize() == 0) {
             return Option<T>::None();
         }
+        return Option<T>::Some(list.LastRef());
     }
 
-    Sequence<T>* GetSubsequence(int startIndex, int endIndex) const override {
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const override {
         if (startIndex < 0 || endIndex >= list.GetSize() || startIndex > endIndex) {
             throw IndexOutOfRangeException("Invalid subsequence indices");
         }
-        int length = endIndex - startIndex + 1;
-        T* items = new T[length];
-        for (int i = 0; i < length; ++i) {
-            items[i] = list.Get(startIndex + i);
+        ListSequence<T, Allocator, List>* result = new ListSequence<T, Allocator, List>(list.GetAllocator());
+        Cursor current = CursorAt(startIndex);
+        for (IndexType i = startIndex; i <= endIndex; ++i, current.MoveNext()) {
+            result->list.Append(current.Get());
         }
-        ListSequence<T>* result = new ListSequence<T>(items, length);
-        delete[] items;
         return result;
     }
 
-    int GetLength() const override {
+    IndexType GetLength() const override {
         return list.GetSize();
     }
 
+    // Курсоры дают только чтение, поэтому доступны и у неизменяемой версии
+    Cursor First() const {
+        return list.First();
+    }
+
+    Cursor Last() const {
+        return list.Last();
+    }
+
+    Cursor CursorAt(IndexType index) const {
+        Cursor current = list.First();
+        for (IndexType i = 0; i < index; ++i) {
+            current.MoveNext();
+        }
+        return current;
+    }
+
+    Allocator GetAllocator() const {
+        return list.GetAllocator();
+    }
+
+    // Выделяет место под count следующих добавлений в конец
+    void Reserve(IndexType count) {
+        list.Reserve(count);
+    }
+
     void Append(const T& item) override {
         list.Append(item);
     }
@@ -121,39 +184,92 @@ public:
         list.Prepend(item);
     }
 
-    void InsertAt(const T& item, int index) override {
+    void InsertAt(const T& item, IndexType index) override {
         list.InsertAt(item, index);
     }
 
-    Sequence<T>* Map(T (*func)(const T&)) const override {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result->Append(func(list.Get(i)));
+    void Append(T&& item) override {
+        list.Append(std::move(item));
+    }
+
+    void Prepend(T&& item) override {
+        list.Prepend(std::move(item));
+    }
+
+    void InsertAt(T&& item, IndexType index) override {
+        list.InsertAt(std::move(item), index);
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        list.EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        list.EmplaceFront(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceAt(IndexType index, Args&&... args) {
+        list.EmplaceAt(index, std::forward<Args>(args)...);
+    }
+
+    virtual T RemoveFirst() {
+        return list.RemoveFirst();
+    }
+
+    virtual T RemoveLast() {
+        return list.RemoveLast();
+    }
+
+    // Дописывает other в конец, забирая его узлы; other становится пустым.
+    // Неизменяемую последовательность опустошить нельзя
+    virtual void ConcatInPlace(ListSequence<T, Allocator, List>& other) {
+        if (!other.CanDonate()) {
+            throw InvalidOperationException("Cannot modify immutable sequence");
+        }
+        list.AppendList(other.list);
+    }
+
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func.
+    // В отличие от массивов, узлы результата не выделяются заранее под всю
+    // длину: один большой блок слаба оказался не быстрее обычного роста
+    // блоками. Значение func перемещается в узел
+    template <typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const {
+        using Result = MapResult<R, Func, T>;
+        using ResultAllocator = ReboundAllocator<Allocator, Result>;
+        auto* result = new ListSequence<Result, ResultAllocator, List>(ResultAllocator(list.GetAllocator()));
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            result->EmplaceBack(func(current.Get()));
         }
         return result;
     }
 
-    Sequence<T>* Where(bool (*predicate)(const T&)) const override {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            T item = list.Get(i);
+    template <typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const {
+        ListSequence<T, Allocator, List>* result = new ListSequence<T, Allocator, List>(list.GetAllocator());
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            const T& item = current.Get();
             if (predicate(item)) {
-                result->Append(item);
+                result->list.Append(item);
             }
         }
         return result;
     }
 
-    T Reduce(T (*func)(const T&, const T&), const T& initial) const override {
+    template <typename Func>
+    T Reduce(Func func, const T& initial) const {
         T result = initial;
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result = func(result, list.Get(i));
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            result = func(result, current.Get());
         }
         return result;
     }
 
-    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
-        int length = list.GetSize();
+    Sequence<T>* Slice(IndexType i, IndexType N, const Sequence<T>* s = nullptr) const override {
+        IndexType length = list.GetSize();
         
         if (i < 0) {
             i = length + i;
@@ -165,56 +281,59 @@ public:
             N = length - i;
         }
         
-        ListSequence<T>* result = new ListSequence<T>();
+        ListSequence<T, Allocator, List>* result = new ListSequence<T, Allocator, List>(list.GetAllocator());
         
-        for (int j = 0; j < i; ++j) {
-            result->Append(list.Get(j));
+        Cursor current = list.First();
+        for (IndexType j = 0; j < i; ++j, current.MoveNext()) {
+            result->list.Append(current.Get());
         }
         
         if (s != nullptr) {
-            for (int j = 0; j < s->GetLength(); ++j) {
-                result->Append(s->Get(j));
-            }
+            AppendAll(result->list, s);
         }
 
-        for (int j = i + N; j < length; ++j) {
-            result->Append(list.Get(j));
+        for (IndexType j = 0; j < N; ++j) {
+            current.MoveNext();
+        }
+        for (; current.IsValid(); current.MoveNext()) {
+            result->list.Append(current.Get());
         }
         
         return result;
     }
 
-    Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            Sequence<T>* subseq = func(list.Get(i));
-            for (int j = 0; j < subseq->GetLength(); ++j) {
-                result->Append(subseq->Get(j));
-            }
+    template <typename Func>
+    Sequence<T>* FlatMap(Func func) const {
+        ListSequence<T, Allocator, List>* result = new ListSequence<T, Allocator, List>(list.GetAllocator());
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            Sequence<T>* subseq = func(current.Get());
+            AppendAll(result->list, subseq);
             delete subseq;
         }
         return result;
     }
 
-    Option<T> Find(bool (*predicate)(const T&)) const override {
-        for (int i = 0; i < list.GetSize(); ++i) {
-            if (predicate(list.Get(i))) {
-                return Option<T>::Some(list.Get(i));
+    template <typename Predicate>
+    Option<T> Find(Predicate predicate) const {
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            if (predicate(current.Get())) {
+                return Option<T>::Some(current.Get());
             }
         }
         return Option<T>::None();
     }
 
-    std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
-        ListSequence<T>* matching = new ListSequence<T>();
-        ListSequence<T>* notMatching = new ListSequence<T>();
+    template <typename Predicate>
+    std::pair<Sequence<T>*, Sequence<T>*> Split(Predicate predicate) const {
+        ListSequence<T, Allocator, List>* matching = new ListSequence<T, Allocator, List>(list.GetAllocator());
+        ListSequence<T, Allocator, List>* notMatching = new ListSequence<T, Allocator, List>(list.GetAllocator());
 
-        for (int i = 0; i < list.GetSize(); ++i) {
-            T current = list.Get(i);
-            if (predicate(current)) {
-                matching->Append(current);
+        for (Cursor current = list.First(); current.IsValid(); current.MoveNext()) {
+            const T& item = current.Get();
+            if (predicate(item)) {
+                matching->list.Append(item);
             } else {
-                notMatching->Append(current);
+                notMatching->list.Append(item);
             }
         }
 
@@ -222,16 +341,8 @@ public:
     }
 
     Sequence<T>* Concat(const Sequence<T>* other) const override {
-        ListSequence<T>* result = new ListSequence<T>();
-        
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result->Append(list.Get(i));
-        }
-        
-        for (int i = 0; i < other->GetLength(); ++i) {
-            result->Append(other->Get(i));
-        }
-        
+        ListSequence<T, Allocator, List>* result = new ListSequence<T, Allocator, List>(list);
+        AppendAll(result->list, other);
         return result;
     }
 
@@ -0,0 +1,209 @@
+#pragma once
+#include <memory>
+#include <utility>
+#include "Index.hpp"
+
+// Слаб узлов одного списка: узлы нарезаются из непрерывных блоков,
+// освобождённые узлы уходят в список свободных и переиспользуются,
+// а вся память возвращается аллокатору поблочно
+template <typename NodeType, typename NodeAllocator>
+class NodeSlab {
+private:
+    using Traits = std::allocator_traits<NodeAllocator>;
+
+    // Первая ячейка каждого блока хранит заголовок блока
+    struct BlockHeader {
+        NodeType* nextBlock;
+        IndexType count;
+    };
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    static_assert(sizeof(BlockHeader) <= sizeof(NodeType), "Node is too small for a slab header");
+    static_assert(sizeof(FreeSlot) <= sizeof(NodeType), "Node is too small for a free-list link");
+
+    static const int FirstBlockNodes = 16;
+    static const int MaxBlockNodes = 4096;
+
+    NodeAllocator allocator;
+    NodeType* blocks;
+    // самый старый блок - конец цепочки, нужен для присоединения чужих блоков
+    NodeType* lastBlock;
+    NodeType* bumpCurrent;
+    NodeType* bumpEnd;
+    FreeSlot* freeList;
+    // последняя свободная ячейка, чтобы присоединять чужой список за O(1);
+    // имеет смысл, только пока freeList не пуст
+    FreeSlot* freeTail;
+    int nextBlockNodes;
+
+    static BlockHeader* Header(NodeType* block) {
+        return reinterpret_cast<BlockHeader*>(block);
+    }
+
+    void AddBlock(IndexType nodeCount) {
+        IndexType count = nodeCount + 1;
+        NodeType* block = Traits::allocate(allocator, count);
+        new (block) BlockHeader{blocks, count};
+        if (!blocks) {
+            lastBlock = block;
+        }
+        blocks = block;
+        bumpCurrent = block + 1;
+        bumpEnd = block + count;
+    }
+
+    void Steal(NodeSlab& other) noexcept {
+        blocks = other.blocks;
+        lastBlock = other.lastBlock;
+        bumpCurrent = other.bumpCurrent;
+        bumpEnd = other.bumpEnd;
+        freeList = other.freeList;
+        freeTail = other.freeTail;
+        nextBlockNodes = other.nextBlockNodes;
+        other.blocks = nullptr;
+        other.lastBlock = nullptr;
+        other.bumpCurrent = nullptr;
+        other.bumpEnd = nullptr;
+        other.freeList = nullptr;
+        other.nextBlockNodes = FirstBlockNodes;
+    }
+
+public:
+    explicit NodeSlab(const NodeAllocator& allocator = NodeAllocator())
+        : allocator(allocator), blocks(nullptr), lastBlock(nullptr), bumpCurrent(nullptr), bumpEnd(nullptr),
+          freeList(nullptr), freeTail(nullptr), nextBlockNodes(FirstBlockNodes) {}
+
+    NodeSlab(const NodeSlab&) = delete;
+    NodeSlab& operator=(const NodeSlab&) = delete;
+
+    NodeSlab(NodeSlab&& other) noexcept
+        : allocator(std::move(other.allocator)), blocks(nullptr), lastBlock(nullptr), bumpCurrent(nullptr),
+          bumpEnd(nullptr), freeList(nullptr), freeTail(nullptr), nextBlockNodes(FirstBlockNodes) {
+        Steal(other);
+    }
+
+    // Вызывающий гарантирует, что в other не осталось живых узлов
+    // или что они переданы вместе с блоками
+    NodeSlab& operator=(NodeSlab&& other) noexcept {
+        if (this != &other) {
+            Release();
+            if (Traits::propagate_on_container_move_assignment::value) {
+                allocator = std::move(other.allocator);
+            }
+            Steal(other);
+        }
+        return *this;
+    }
+
+    ~NodeSlab() {
+        Release();
+    }
+
+    const NodeAllocator& GetAllocator() const {
+        return allocator;
+    }
+
+    template <typename... Args>
+    NodeType* Create(Args&&... args) {
+        NodeType* place;
+        if (freeList) {
+            place = reinterpret_cast<NodeType*>(freeList);
+            freeList = freeList->next;
+        } else {
+            if (bumpCurrent == bumpEnd) {
+                AddBlock(nextBlockNodes);
+                if (nextBlockNodes < MaxBlockNodes) {
+                    nextBlockNodes *= 2;
+                }
+            }
+            place = bumpCurrent++;
+        }
+        try {
+            Traits::construct(allocator, place, std::forward<Args>(args)...);
+        } catch (...) {
+            Recycle(place);
+            throw;
+        }
+        return place;
+    }
+
+    // Готовит место под count узлов одним блоком, чтобы заранее известное
+    // число вставок не выделяло память по частям. Остаток текущего блока
+    // уходит в список свободных и выдаётся первым
+    void Reserve(IndexType count) {
+        if (bumpEnd - bumpCurrent >= count) {
+            return;
+        }
+        while (bumpCurrent != bumpEnd) {
+            Recycle(bumpCurrent++);
+        }
+        AddBlock(count);
+    }
+
+    void Destroy(NodeType* node) {
+        Traits::destroy(allocator, node);
+        Recycle(node);
+    }
+
+    // Возвращает память узла в список свободных без вызова деструктора
+    void Recycle(NodeType* node) noexcept {
+        FreeSlot* slot = new (node) FreeSlot;
+        if (!freeList) {
+            freeTail = slot;
+        }
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    // Забирает блоки other, чтобы его узлы могли жить в этом слабе.
+    // Аллокаторы должны быть равны. Свободные ячейки other присоединяются
+    // за O(1); из двух незанятых остатков блоков больший остаётся текущим,
+    // а меньший уходит в список свободных, так что ёмкость не теряется
+    void Adopt(NodeSlab& other) noexcept {
+        if (this == &other || !other.blocks) {
+            return;
+        }
+        Header(other.lastBlock)->nextBlock = blocks;
+        if (!blocks) {
+            lastBlock = other.lastBlock;
+        }
+        blocks = other.blocks;
+        if (other.freeList) {
+            other.freeTail->next = freeList;
+            if (!freeList) {
+                freeTail = other.freeTail;
+            }
+            freeList = other.freeList;
+        }
+        if (other.bumpEnd - other.bumpCurrent > bumpEnd - bumpCurrent) {
+            std::swap(bumpCurrent, other.bumpCurrent);
+            std::swap(bumpEnd, other.bumpEnd);
+        }
+        while (other.bumpCurrent != other.bumpEnd) {
+            Recycle(other.bumpCurrent++);
+        }
+        if (other.nextBlockNodes > nextBlockNodes) {
+            nextBlockNodes = other.nextBlockNodes;
+        }
+        other.blocks = nullptr;
+        other.Release();
+    }
+
+    // Отдаёт аллокатору все блоки; живые узлы должны быть уже разрушены
+    void Release() noexcept {
+        while (blocks) {
+            NodeType* next = Header(blocks)->nextBlock;
+            Traits::deallocate(allocator, blocks, Header(blocks)->count);
+            blocks = next;
+        }
+        lastBlock = nullptr;
+        bumpCurrent = nullptr;
+        bumpEnd = nullptr;
+        freeList = nullptr;
+        freeTail = nullptr;
+        nextBlockNodes = FirstBlockNodes;
+    }
+};
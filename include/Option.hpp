@@ -1,30 +1,93 @@
 #pragma once
+#include <new>
+#include <utility>
 #include "Exceptions.hpp"
 
 template <typename T>
 class Option {
 private:
     bool hasValue;
-    T value;
+    // значение живёт в union, поэтому пустой Option не требует T()
+    union {
+        T value;
+    };
+
+    void Reset() {
+        if (hasValue) {
+            value.~T();
+            hasValue = false;
+        }
+    }
 
 public:
     Option() : hasValue(false) {}
     Option(const T& val) : hasValue(true), value(val) {}
+    Option(T&& val) : hasValue(true), value(std::move(val)) {}
     // from
-    Option(const Option& other) = default;
+    Option(const Option& other) : hasValue(false) {
+        if (other.hasValue) {
+            new (&value) T(other.value);
+            hasValue = true;
+        }
+    }
+    Option(Option&& other) : hasValue(false) {
+        if (other.hasValue) {
+            new (&value) T(std::move(other.value));
+            hasValue = true;
+        }
+    }
+
+    Option& operator=(const Option& other) {
+        if (this != &other) {
+            Reset();
+            if (other.hasValue) {
+                new (&value) T(other.value);
+                hasValue = true;
+            }
+        }
+        return *this;
+    }
+    Option& operator=(Option&& other) {
+        if (this != &other) {
+            Reset();
+            if (other.hasValue) {
+                new (&value) T(std::move(other.value));
+                hasValue = true;
+            }
+        }
+        return *this;
+    }
 
-    Option& operator=(const Option& other) = default;
+    ~Option() {
+        Reset();
+    }
 
     bool isSome() const { return hasValue; }
     bool isNone() const { return !hasValue; }
 
-    T getValue() const {
+    const T& getValue() const & {
+        if (!hasValue) {
+            throw InvalidArgumentException("Attempt to get value from None");
+        }
+        return value;
+    }
+
+    T& getValue() & {
         if (!hasValue) {
             throw InvalidArgumentException("Attempt to get value from None");
         }
         return value;
     }
 
+    // из временного Option значение забирается перемещением
+    T getValue() && {
+        if (!hasValue) {
+            throw InvalidArgumentException("Attempt to get value from None");
+        }
+        return std::move(value);
+    }
+
     static Option None() { return Option(); }
     static Option Some(const T& val) { return Option(val); }
-};
\ No newline at end of file
+    static Option Some(T&& val) { return Option(std::move(val)); }
+};
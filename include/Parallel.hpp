@@ -0,0 +1,220 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+#include "Option.hpp"
+
+// Параллельные ядра принимают только непрерывные массивы (const T*) и не
+// обращаются к спискам по индексу: константный Get у LinkedList пишет в палец
+
+// Размер куска по умолчанию: достаточно велик, чтобы захват куска через
+// атомарный счётчик не был заметен, и достаточно мал для балансировки
+inline constexpr IndexType ParallelChunkSize = IndexType(1) << 16;
+
+inline IndexType ParallelChunkCount(IndexType count, IndexType chunkSize) {
+    if (chunkSize <= 0) {
+        throw InvalidArgumentException("Chunk size must be positive");
+    }
+    return count <= 0 ? 0 : (count + chunkSize - 1) / chunkSize;
+}
+
+// Делит [0, count) на куски по chunkSize и раздаёт их потокам по мере
+// освобождения; вызывающий поток работает наравне с остальными.
+// body(chunk, begin, end) вызывается ровно один раз для каждого куска.
+// Первое исключение из body прекращает раздачу и пробрасывается наружу
+template <typename Body>
+void ParallelFor(IndexType count, IndexType chunkSize, Body body) {
+    IndexType chunks = ParallelChunkCount(count, chunkSize);
+    if (chunks == 0) {
+        return;
+    }
+
+    std::atomic<IndexType> nextChunk(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto work = [&]() {
+        for (IndexType chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+            if (failed.load(std::memory_order_relaxed)) {
+                return;
+            }
+            IndexType begin = chunk * chunkSize;
+            try {
+                body(chunk, begin, std::min(begin + chunkSize, count));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+                return;
+            }
+        }
+    };
+
+    IndexType threadCount = std::max<IndexType>(1, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, chunks);
+    DynamicArray<std::thread> threads;
+    try {
+        threads.Reserve(threadCount - 1);
+        for (IndexType i = 1; i < threadCount; ++i) {
+            threads.EmplaceBack(work);
+        }
+    } catch (...) {
+        // если потоков не хватило, куски доработают уже запущенные и этот
+    }
+    work();
+    for (IndexType i = 0; i < threads.GetSize(); ++i) {
+        threads[i].join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Параллельно строит total элементов в сырой памяти за концом result и
+// включает их в размер. Кусок chunk входных данных [begin, end) пишет свои
+// элементы подряд с позиции start(chunk) через emit(args...). Если хоть
+// один кусок выбросил исключение, всё построенное разрушается и result
+// остаётся прежним. Конструктор по умолчанию элементам не нужен
+template <typename Output, typename Start, typename Build>
+void ParallelConstruct(Output& result, IndexType count, IndexType total, IndexType chunkSize,
+                       Start start, Build build) {
+    IndexType base = result.GetSize();
+    DynamicArray<IndexType> built;
+    built.Resize(ParallelChunkCount(count, chunkSize));
+    result.Reserve(base + total);
+    try {
+        ParallelFor(count, chunkSize, [&](IndexType chunk, IndexType begin, IndexType end) {
+            IndexType first = base + start(chunk);
+            IndexType position = first;
+            auto emit = [&](auto&&... args) {
+                result.ConstructAt(position, std::forward<decltype(args)>(args)...);
+                ++position;
+            };
+            try {
+                build(begin, end, emit);
+            } catch (...) {
+                for (; position > first; --position) {
+                    result.DestroyAt(position - 1);
+                }
+                throw;
+            }
+            built[chunk] = position - first;
+        });
+    } catch (...) {
+        for (IndexType chunk = 0; chunk < built.GetSize(); ++chunk) {
+            IndexType first = base + start(chunk);
+            for (IndexType i = 0; i < built[chunk]; ++i) {
+                result.DestroyAt(first + i);
+            }
+        }
+        throw;
+    }
+    result.CommitConstructed(total);
+}
+
+// Ядра ниже работают над непрерывным массивом и дописывают в result;
+// func и predicate вызываются из нескольких потоков одновременно
+template <typename T, typename Func, typename Output>
+void ParallelMapRange(const T* items, IndexType count, Func& func, IndexType chunkSize, Output& result) {
+    ParallelConstruct(result, count, count, chunkSize,
+        [chunkSize](IndexType chunk) { return chunk * chunkSize; },
+        [&](IndexType begin, IndexType end, auto& emit) {
+            for (IndexType i = begin; i < end; ++i) {
+                emit(func(items[i]));
+            }
+        });
+}
+
+// Два прохода: отметки и число отобранных в каждом куске, затем
+// копирование по смещениям из префиксных сумм - порядок сохраняется,
+// predicate вызывается для каждого элемента один раз
+template <typename T, typename Predicate, typename Output>
+void ParallelWhereRange(const T* items, IndexType count, Predicate& predicate, IndexType chunkSize, Output& result) {
+    DynamicArray<IndexType> offsets;
+    offsets.Resize(ParallelChunkCount(count, chunkSize));
+    DynamicArray<unsigned char> keep;
+    keep.Resize(count);
+    unsigned char* flags = keep.Data();
+    IndexType* kept = offsets.Data();
+    ParallelFor(count, chunkSize, [&](IndexType chunk, IndexType begin, IndexType end) {
+        IndexType selected = 0;
+        for (IndexType i = begin; i < end; ++i) {
+            flags[i] = predicate(items[i]) ? 1 : 0;
+            selected += flags[i];
+        }
+        kept[chunk] = selected;
+    });
+
+    IndexType total = 0;
+    for (IndexType chunk = 0; chunk < offsets.GetSize(); ++chunk) {
+        IndexType selected = kept[chunk];
+        kept[chunk] = total;
+        total += selected;
+    }
+
+    ParallelConstruct(result, count, total, chunkSize,
+        [kept](IndexType chunk) { return kept[chunk]; },
+        [&](IndexType begin, IndexType end, auto& emit) {
+            for (IndexType i = begin; i < end; ++i) {
+                if (flags[i]) {
+                    emit(items[i]);
+                }
+            }
+        });
+}
+
+// func должна быть ассоциативной: куски сворачиваются независимо и
+// объединяются слева направо, так что коммутативность не нужна
+template <typename T, typename Func>
+T ParallelReduceRange(const T* items, IndexType count, Func& func, const T& initial, IndexType chunkSize) {
+    DynamicArray<Option<T>> partials;
+    partials.Resize(ParallelChunkCount(count, chunkSize));
+    ParallelFor(count, chunkSize, [&](IndexType chunk, IndexType begin, IndexType end) {
+        T accumulator = items[begin];
+        for (IndexType i = begin + 1; i < end; ++i) {
+            accumulator = func(accumulator, items[i]);
+        }
+        partials[chunk] = Option<T>::Some(std::move(accumulator));
+    });
+
+    T result = initial;
+    for (IndexType chunk = 0; chunk < partials.GetSize(); ++chunk) {
+        result = func(result, partials[chunk].getValue());
+    }
+    return result;
+}
+
+// Индекс первого подходящего элемента или -1. Куски раздаются по
+// возрастанию, и кусок, целиком лежащий правее уже найденного индекса,
+// не просматривается; внутри куска проверка повторяется каждые CheckStep
+template <typename T, typename Predicate>
+IndexType ParallelFindRange(const T* items, IndexType count, Predicate& predicate, IndexType chunkSize) {
+    const IndexType CheckStep = 1024;
+    std::atomic<IndexType> found(count);
+    ParallelFor(count, chunkSize, [&](IndexType, IndexType begin, IndexType end) {
+        for (IndexType block = begin; block < end; block += CheckStep) {
+            if (found.load(std::memory_order_relaxed) < block) {
+                return;
+            }
+            IndexType blockEnd = std::min(block + CheckStep, end);
+            for (IndexType i = block; i < blockEnd; ++i) {
+                if (predicate(items[i])) {
+                    IndexType current = found.load();
+                    while (i < current && !found.compare_exchange_weak(current, i)) {
+                    }
+                    return;
+                }
+            }
+        }
+    });
+    IndexType index = found.load();
+    return index < count ? index : -1;
+}
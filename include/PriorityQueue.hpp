@@ -1,172 +1,302 @@
 #pragma once
 
 #include <utility>
+#include <tuple>
 #include <algorithm>
+#include <memory>
+#include "DynamicArray.hpp"
+#include "LinkedList.hpp"
 #include "ListSequence.hpp"
 #include "Exceptions.hpp"
 #include "IEnumerable.hpp"
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>>
 class PriorityQueue : public IEnumerable<T> {
 private:
-    ListSequence<std::pair<T, int>> items;
+    using Entry = std::pair<T, int>;
+    using EntryAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Entry>;
+    using EntryList = LinkedList<Entry, EntryAllocator>;
+    using EntryCursor = typename EntryList::Cursor;
+
+    // Ячейка кучи: приоритет, номер добавления и узел записи в items
+    struct HeapSlot
+    {
+        int priority;
+        unsigned long long order;
+        EntryCursor entry;
+    };
+    using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<HeapSlot>;
+
+    // Записи хранятся в порядке добавления: в нём идут перечисление, Where,
+    // Reduce, GetSequence, ContainsSubsequence и Split. Бинарная куча над
+    // ними даёт Front за O(1), Enqueue и Dequeue за O(log N); равные
+    // приоритеты выходят в порядке добавления
+    EntryList items;
+    DynamicArray<HeapSlot, SlotAllocator> heap;
+    unsigned long long nextOrder = 0;
 
     class PriorityQueueEnumerator : public IEnumerator<T> {
     private:
-        const ListSequence<std::pair<T, int>>& sequence;
-        int currentIndex;
-        T currentValue;
+        const EntryList& list;
+        EntryCursor current;
+        bool isBeforeFirst;
 
     public:
-        explicit PriorityQueueEnumerator(const ListSequence<std::pair<T, int>>& seq)
-            : sequence(seq)
-            , currentIndex(-1)
+        explicit PriorityQueueEnumerator(const EntryList& list)
+            : list(list)
+            , current()
+            , isBeforeFirst(true)
         {
         }
 
         bool MoveNext() override
         {
-            if (currentIndex + 1 < sequence.GetLength())
+            if (isBeforeFirst)
             {
-                currentIndex++;
-                currentValue = sequence.Get(currentIndex).first;
-                return true;
+                current = list.First();
+                isBeforeFirst = false;
             }
-            return false;
+            else
+            {
+                current.MoveNext();
+            }
+            return current.IsValid();
         }
 
         const T& Current() const override
         {
-            if (currentIndex < 0 || currentIndex >= sequence.GetLength())
+            if (!current.IsValid())
             {
                 throw InvalidStateException("Enumerator is not in a valid position");
             }
-            return currentValue;
+            return current.Get().first;
         }
 
         void Reset() override
         {
-            currentIndex = -1;
+            current = EntryCursor();
+            isBeforeFirst = true;
         }
     };
 
-public:
-    PriorityQueue() = default;
-
-    void Enqueue(const T& item, int priority)
+    static bool Before(const HeapSlot& left, const HeapSlot& right)
     {
-        items.Append(std::make_pair(item, priority));
+        return left.priority > right.priority
+            || (left.priority == right.priority && left.order < right.order);
     }
 
-    Option<T> Dequeue()
+    void SiftUp(IndexType index)
     {
-        if (items.GetLength() == 0)
+        HeapSlot slot = heap[index];
+        while (index > 0 && Before(slot, heap[(index - 1) / 2]))
         {
-            return Option<T>::None();
+            heap[index] = heap[(index - 1) / 2];
+            index = (index - 1) / 2;
         }
-        int maxPriorityIndex = 0;
-        int maxPriority = items.Get(0).second;
-        for (int i = 1; i < items.GetLength(); ++i)
+        heap[index] = slot;
+    }
+
+    void SiftDown(IndexType index)
+    {
+        IndexType size = heap.GetSize();
+        HeapSlot slot = heap[index];
+        for (IndexType child = 2 * index + 1; child < size; child = 2 * index + 1)
         {
-            if (items.Get(i).second > maxPriority)
+            if (child + 1 < size && Before(heap[child + 1], heap[child]))
             {
-                maxPriority = items.Get(i).second;
-                maxPriorityIndex = i;
+                ++child;
             }
+            if (!Before(heap[child], slot))
+            {
+                break;
+            }
+            heap[index] = heap[child];
+            index = child;
         }
+        heap[index] = slot;
+    }
 
-        T value = items.Get(maxPriorityIndex).first;
-        ListSequence<std::pair<T, int>> newItems;
-        for (int i = 0; i < items.GetLength(); ++i)
+    template<typename... Args>
+    void Insert(int priority, Args&&... args)
+    {
+        items.EmplaceBack(std::forward<Args>(args)...);
+        try
         {
-            if (i != maxPriorityIndex)
-            {
-                newItems.Append(items.Get(i));
-            }
+            heap.EmplaceBack(HeapSlot{priority, nextOrder, items.Last()});
         }
-        items = newItems;
-        return Option<T>::Some(value);
+        catch (...)
+        {
+            items.RemoveLast();
+            throw;
+        }
+        ++nextOrder;
+        SiftUp(heap.GetSize() - 1);
     }
 
-    Option<T> Front() const
+    // Заново строит кучу по items за O(N), например после копирования
+    void RebuildHeap()
     {
-        if (items.GetLength() == 0)
+        heap.Clear();
+        heap.Reserve(items.GetSize());
+        nextOrder = 0;
+        for (EntryCursor entry = items.First(); entry.IsValid(); entry.MoveNext())
         {
-            return Option<T>::None();
+            heap.EmplaceBack(HeapSlot{entry.Get().second, nextOrder++, entry});
+        }
+        for (IndexType i = heap.GetSize() / 2 - 1; i >= 0; --i)
+        {
+            SiftDown(i);
         }
+    }
+
+    // Ячейки всех записей по убыванию приоритета - для Map и GetSubsequence
+    DynamicArray<HeapSlot, SlotAllocator> ByPriority() const
+    {
+        DynamicArray<HeapSlot, SlotAllocator> slots(heap);
+        std::sort(slots.Data(), slots.Data() + slots.GetSize(), Before);
+        return slots;
+    }
+
+public:
+    PriorityQueue() = default;
+    explicit PriorityQueue(const Allocator& allocator)
+        : items(EntryAllocator(allocator)), heap(SlotAllocator(allocator)) {}
+
+    // Копия ссылается на свои узлы, поэтому куча строится заново
+    PriorityQueue(const PriorityQueue& other)
+        : items(other.items), heap(SlotAllocator(other.heap.GetAllocator()))
+    {
+        RebuildHeap();
+    }
+
+    PriorityQueue(PriorityQueue&& other) = default;
 
-        int maxPriorityIndex = 0;
-        int maxPriority = items.Get(0).second;
-        for (int i = 1; i < items.GetLength(); ++i)
+    PriorityQueue& operator=(const PriorityQueue& other)
+    {
+        if (this != &other)
         {
-            if (items.Get(i).second > maxPriority)
-            {
-                maxPriority = items.Get(i).second;
-                maxPriorityIndex = i;
-            }
+            items = other.items;
+            RebuildHeap();
+        }
+        return *this;
+    }
+
+    // Узлы переходят целиком, если аллокаторы позволяют; иначе список
+    // переносится поэлементно, и кучу приходится строить заново
+    PriorityQueue& operator=(PriorityQueue&& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+        const Entry* first = other.items.GetSize() > 0 ? &other.items.FirstRef() : nullptr;
+        items = std::move(other.items);
+        if (first && &items.FirstRef() == first)
+        {
+            heap = std::move(other.heap);
+            nextOrder = other.nextOrder;
         }
+        else
+        {
+            RebuildHeap();
+        }
+        other.heap.Clear();
+        other.nextOrder = 0;
+        return *this;
+    }
 
-        return Option<T>::Some(items.Get(maxPriorityIndex).first);
+    void Enqueue(const T& item, int priority)
+    {
+        Insert(priority, item, priority);
     }
 
-    bool IsEmpty() const
+    void Enqueue(T&& item, int priority)
     {
-        return items.GetLength() == 0;
+        Insert(priority, std::move(item), priority);
     }
 
-    int GetSize() const
+    template<typename... Args>
+    void Emplace(int priority, Args&&... args)
     {
-        return items.GetLength();
+        Insert(priority, std::piecewise_construct,
+               std::forward_as_tuple(std::forward<Args>(args)...),
+               std::forward_as_tuple(priority));
     }
 
-    Sequence<T>* GetSequence() const
+    Option<T> Dequeue()
     {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < items.GetLength(); ++i)
+        if (items.GetSize() == 0)
+        {
+            return Option<T>::None();
+        }
+        HeapSlot top = heap[0];
+        heap[0] = heap[heap.GetSize() - 1];
+        heap.PopBack();
+        if (heap.GetSize() > 0)
         {
-            result->Append(items.Get(i).first);
+            SiftDown(0);
         }
-        return result;
+        return Option<T>::Some(items.Extract(top.entry).first);
     }
 
-    Sequence<T>* Map(T (*func)(const T&)) const
+    Option<T> Front() const
     {
-        int size = items.GetLength();
-        auto* pairs = new std::pair<T, int>[size];
-        for (int i = 0; i < size; ++i)
+        if (items.GetSize() == 0)
         {
-            pairs[i] = items.Get(i);
+            return Option<T>::None();
         }
-        
-        for (int i = 0; i < size - 1; ++i)
+        return Option<T>::Some(heap[0].entry.Get().first);
+    }
+
+    bool IsEmpty() const
+    {
+        return items.GetSize() == 0;
+    }
+
+    IndexType GetSize() const
+    {
+        return items.GetSize();
+    }
+
+    Allocator GetAllocator() const
+    {
+        return Allocator(items.GetAllocator());
+    }
+
+    Sequence<T>* GetSequence() const
+    {
+        ListSequence<T, Allocator>* result = new ListSequence<T, Allocator>(GetAllocator());
+        for (EntryCursor entry = items.First(); entry.IsValid(); entry.MoveNext())
         {
-            for (int j = 0; j < size - i - 1; ++j)
-            {
-                if (pairs[j].second < pairs[j + 1].second)
-                {
-                    auto temp = pairs[j];
-                    pairs[j] = pairs[j + 1];
-                    pairs[j + 1] = temp;
-                }
-            }
+            result->Append(entry.Get().first);
         }
-        
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < size; ++i)
+        return result;
+    }
+
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func.
+    // Результат идёт по убыванию приоритета; это список, и его узлы растут
+    // блоками, как в ListSequence::Map, а не выделяются сразу под всю длину
+    template<typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const
+    {
+        using Result = MapResult<R, Func, T>;
+        using ResultAllocator = ReboundAllocator<Allocator, Result>;
+        auto* result = new ListSequence<Result, ResultAllocator>(ResultAllocator(GetAllocator()));
+        DynamicArray<HeapSlot, SlotAllocator> slots = ByPriority();
+        for (IndexType i = 0; i < slots.GetSize(); ++i)
         {
-            result->Append(func(pairs[i].first));
+            result->EmplaceBack(func(slots[i].entry.Get().first));
         }
-        
-        delete[] pairs;
         return result;
     }
 
-    Sequence<T>* Where(bool (*predicate)(const T&)) const
+    template<typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const
     {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < items.GetLength(); ++i)
+        ListSequence<T, Allocator>* result = new ListSequence<T, Allocator>(GetAllocator());
+        for (EntryCursor entry = items.First(); entry.IsValid(); entry.MoveNext())
         {
-            T current = items.Get(i).first;
+            const T& current = entry.Get().first;
             if (predicate(current))
             {
                 result->Append(current);
@@ -175,64 +305,45 @@ public:
         return result;
     }
 
-    T Reduce(T (*func)(const T&, const T&), const T& initial) const
+    template<typename Func>
+    T Reduce(Func func, const T& initial) const
     {
         T result = initial;
-        for (int i = 0; i < items.GetLength(); ++i)
+        for (EntryCursor entry = items.First(); entry.IsValid(); entry.MoveNext())
         {
-            result = func(result, items.Get(i).first);
+            result = func(result, entry.Get().first);
         }
         return result;
     }
 
-    PriorityQueue<T>* Concat(const PriorityQueue<T>* other) const
+    PriorityQueue<T, Allocator>* Concat(const PriorityQueue<T, Allocator>* other) const
     {
-        PriorityQueue<T>* result = new PriorityQueue<T>();
-        for (int i = 0; i < items.GetLength(); ++i)
+        PriorityQueue<T, Allocator>* result = new PriorityQueue<T, Allocator>(GetAllocator());
+        for (EntryCursor entry = items.First(); entry.IsValid(); entry.MoveNext())
         {
-            result->Enqueue(items.Get(i).first, items.Get(i).second);
+            result->Enqueue(entry.Get().first, entry.Get().second);
         }
-        for (int i = 0; i < other->items.GetLength(); ++i)
+        for (EntryCursor entry = other->items.First(); entry.IsValid(); entry.MoveNext())
         {
-            result->Enqueue(other->items.Get(i).first, other->items.Get(i).second);
+            result->Enqueue(entry.Get().first, entry.Get().second);
         }
         return result;
     }
 
-    Sequence<T>* GetSubsequence(int startIndex, int endIndex) const
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const
     {
-        if (startIndex < 0 || endIndex >= items.GetLength() || startIndex > endIndex)
+        if (startIndex < 0 || endIndex >= items.GetSize() || startIndex > endIndex)
         {
             throw IndexOutOfRangeException("Invalid subsequence indices");
         }
 
-        int size = items.GetLength();
-        auto* pairs = new std::pair<T, int>[size];
-        for (int i = 0; i < size; ++i)
-        {
-            pairs[i] = items.Get(i);
-        }
-        
-        for (int i = 0; i < size - 1; ++i)
-        {
-            for (int j = 0; j < size - i - 1; ++j)
-            {
-                if (pairs[j].second < pairs[j + 1].second)
-                {
-                    auto temp = pairs[j];
-                    pairs[j] = pairs[j + 1];
-                    pairs[j + 1] = temp;
-                }
-            }
-        }
-
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = startIndex; i <= endIndex; ++i)
+        // индексы считаются в порядке убывания приоритета
+        DynamicArray<HeapSlot, SlotAllocator> slots = ByPriority();
+        ListSequence<T, Allocator>* result = new ListSequence<T, Allocator>(GetAllocator());
+        for (IndexType i = startIndex; i <= endIndex; ++i)
         {
-            result->Append(pairs[i].first);
+            result->Append(slots[i].entry.Get().first);
         }
-        
-        delete[] pairs;
         return result;
     }
 
@@ -242,17 +353,19 @@ public:
         {
             return true;
         }
-        if (subseq->GetLength() > items.GetLength())
+        if (subseq->GetLength() > items.GetSize())
         {
             return false;
         }
 
-        for (int i = 0; i <= items.GetLength() - subseq->GetLength(); ++i)
+        EntryCursor start = items.First();
+        for (IndexType i = 0; i <= items.GetSize() - subseq->GetLength(); ++i, start.MoveNext())
         {
             bool match = true;
-            for (int j = 0; j < subseq->GetLength(); ++j)
+            EntryCursor entry = start;
+            for (IndexType j = 0; j < subseq->GetLength(); ++j, entry.MoveNext())
             {
-                if (!(items.Get(i + j).first == subseq->Get(j)))
+                if (!(entry.Get().first == subseq->At(j)))
                 {
                     match = false;
                     break;
@@ -266,15 +379,16 @@ public:
         return false;
     }
 
-    std::pair<PriorityQueue<T>*, PriorityQueue<T>*> Split(bool (*predicate)(const T&)) const
+    template<typename Predicate>
+    std::pair<PriorityQueue<T, Allocator>*, PriorityQueue<T, Allocator>*> Split(Predicate predicate) const
     {
-        PriorityQueue<T>* matching = new PriorityQueue<T>();
-        PriorityQueue<T>* notMatching = new PriorityQueue<T>();
+        PriorityQueue<T, Allocator>* matching = new PriorityQueue<T, Allocator>(GetAllocator());
+        PriorityQueue<T, Allocator>* notMatching = new PriorityQueue<T, Allocator>(GetAllocator());
 
-        for (int i = 0; i < items.GetLength(); ++i)
+        for (EntryCursor entry = items.First(); entry.IsValid(); entry.MoveNext())
         {
-            T current = items.Get(i).first;
-            int priority = items.Get(i).second;
+            const T& current = entry.Get().first;
+            int priority = entry.Get().second;
             if (predicate(current))
             {
                 matching->Enqueue(current, priority);
@@ -0,0 +1,516 @@
+#pragma once
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "IEnumerable.hpp"
+#include "ArraySequence.hpp"
+#include "ListSequence.hpp"
+
+// Ленивые запросы над IEnumerable. Каждая стадия - шаблонный класс с
+// курсором, который тянет элементы из курсора предыдущей стадии, поэтому
+// цепочка Where/Map/Take/... сливается в один проход без промежуточных
+// последовательностей. Элементы вычисляются только при материализации:
+// ToArraySequence, ToListSequence, Reduce, ForEach, Count.
+// Запрос хранит ссылку на источник, и источник должен его пережить.
+// У курсора каждой стадии есть MoveNext() и Current(), возвращающий
+// const ValueType&, который действителен до следующего MoveNext
+
+template <typename T>
+class QuerySource {
+private:
+    const IEnumerable<T>* source;
+
+public:
+    using ValueType = T;
+
+    class Cursor {
+    private:
+        IEnumerator<T>* enumerator;
+
+    public:
+        explicit Cursor(const IEnumerable<T>* source) : enumerator(source->GetEnumerator()) {}
+        Cursor(Cursor&& other) noexcept : enumerator(other.enumerator) {
+            other.enumerator = nullptr;
+        }
+        Cursor(const Cursor&) = delete;
+        Cursor& operator=(const Cursor&) = delete;
+
+        ~Cursor() {
+            delete enumerator;
+        }
+
+        bool MoveNext() {
+            return enumerator->MoveNext();
+        }
+
+        const T& Current() const {
+            return enumerator->Current();
+        }
+    };
+
+    explicit QuerySource(const IEnumerable<T>& source) : source(&source) {}
+
+    Cursor Open() const {
+        return Cursor(source);
+    }
+};
+
+// Источники для ArraySequence и ListSequence обходят хранилище напрямую,
+// без виртуальных MoveNext/Current на каждый элемент
+template <typename T, typename Container>
+class QueryArraySource {
+private:
+    const Container* source;
+
+public:
+    using ValueType = T;
+
+    class Cursor {
+    private:
+        const T* items;
+        IndexType count;
+        IndexType index;
+
+    public:
+        Cursor(const T* items, IndexType count) : items(items), count(count), index(-1) {}
+
+        bool MoveNext() {
+            return ++index < count;
+        }
+
+        const T& Current() const {
+            return items[index];
+        }
+    };
+
+    explicit QueryArraySource(const Container& source) : source(&source) {}
+
+    Cursor Open() const {
+        return Cursor(source->Data(), source->GetLength());
+    }
+};
+
+template <typename T, typename Container>
+class QueryListSource {
+private:
+    const Container* source;
+
+public:
+    using ValueType = T;
+
+    class Cursor {
+    private:
+        typename Container::Cursor current;
+        bool started;
+
+    public:
+        explicit Cursor(typename Container::Cursor first) : current(first), started(false) {}
+
+        bool MoveNext() {
+            if (started) {
+                current.MoveNext();
+            }
+            started = true;
+            return current.IsValid();
+        }
+
+        const T& Current() const {
+            return current.Get();
+        }
+    };
+
+    explicit QueryListSource(const Container& source) : source(&source) {}
+
+    Cursor Open() const {
+        return Cursor(source->First());
+    }
+};
+
+template <typename Inner, typename Predicate>
+class QueryWhere {
+private:
+    Inner inner;
+    Predicate predicate;
+
+public:
+    using ValueType = typename Inner::ValueType;
+
+    class Cursor {
+    private:
+        typename Inner::Cursor inner;
+        const Predicate* predicate;
+
+    public:
+        Cursor(typename Inner::Cursor inner, const Predicate* predicate)
+            : inner(std::move(inner)), predicate(predicate) {}
+
+        bool MoveNext() {
+            while (inner.MoveNext()) {
+                if ((*predicate)(inner.Current())) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        const ValueType& Current() const {
+            return inner.Current();
+        }
+    };
+
+    QueryWhere(Inner inner, Predicate predicate) : inner(std::move(inner)), predicate(std::move(predicate)) {}
+
+    Cursor Open() const {
+        return Cursor(inner.Open(), &predicate);
+    }
+};
+
+// Значение func строится на месте в курсоре и живёт до следующего шага
+template <typename Inner, typename Func>
+class QueryMap {
+private:
+    Inner inner;
+    Func func;
+
+public:
+    using ValueType = std::decay_t<std::invoke_result_t<const Func&, const typename Inner::ValueType&>>;
+
+    class Cursor {
+    private:
+        typename Inner::Cursor inner;
+        const Func* func;
+        std::optional<ValueType> value;
+
+    public:
+        Cursor(typename Inner::Cursor inner, const Func* func) : inner(std::move(inner)), func(func) {}
+
+        bool MoveNext() {
+            if (!inner.MoveNext()) {
+                return false;
+            }
+            value.emplace((*func)(inner.Current()));
+            return true;
+        }
+
+        const ValueType& Current() const {
+            return *value;
+        }
+    };
+
+    QueryMap(Inner inner, Func func) : inner(std::move(inner)), func(std::move(func)) {}
+
+    Cursor Open() const {
+        return Cursor(inner.Open(), &func);
+    }
+};
+
+// Не запрашивает у источника ни одного элемента сверх count
+template <typename Inner>
+class QueryTake {
+private:
+    Inner inner;
+    IndexType count;
+
+public:
+    using ValueType = typename Inner::ValueType;
+
+    class Cursor {
+    private:
+        typename Inner::Cursor inner;
+        IndexType remaining;
+
+    public:
+        Cursor(typename Inner::Cursor inner, IndexType remaining) : inner(std::move(inner)), remaining(remaining) {}
+
+        bool MoveNext() {
+            if (remaining <= 0) {
+                return false;
+            }
+            --remaining;
+            return inner.MoveNext();
+        }
+
+        const ValueType& Current() const {
+            return inner.Current();
+        }
+    };
+
+    QueryTake(Inner inner, IndexType count) : inner(std::move(inner)), count(count) {}
+
+    Cursor Open() const {
+        return Cursor(inner.Open(), count);
+    }
+};
+
+template <typename Inner>
+class QuerySkip {
+private:
+    Inner inner;
+    IndexType count;
+
+public:
+    using ValueType = typename Inner::ValueType;
+
+    class Cursor {
+    private:
+        typename Inner::Cursor inner;
+        IndexType toSkip;
+
+    public:
+        Cursor(typename Inner::Cursor inner, IndexType toSkip) : inner(std::move(inner)), toSkip(toSkip) {}
+
+        bool MoveNext() {
+            for (; toSkip > 0; --toSkip) {
+                if (!inner.MoveNext()) {
+                    toSkip = 0;
+                    return false;
+                }
+            }
+            return inner.MoveNext();
+        }
+
+        const ValueType& Current() const {
+            return inner.Current();
+        }
+    };
+
+    QuerySkip(Inner inner, IndexType count) : inner(std::move(inner)), count(count) {}
+
+    Cursor Open() const {
+        return Cursor(inner.Open(), count);
+    }
+};
+
+template <typename Inner, typename Predicate>
+class QueryTakeWhile {
+private:
+    Inner inner;
+    Predicate predicate;
+
+public:
+    using ValueType = typename Inner::ValueType;
+
+    class Cursor {
+    private:
+        typename Inner::Cursor inner;
+        const Predicate* predicate;
+        bool finished;
+
+    public:
+        Cursor(typename Inner::Cursor inner, const Predicate* predicate)
+            : inner(std::move(inner)), predicate(predicate), finished(false) {}
+
+        bool MoveNext() {
+            if (finished || !inner.MoveNext() || !(*predicate)(inner.Current())) {
+                finished = true;
+                return false;
+            }
+            return true;
+        }
+
+        const ValueType& Current() const {
+            return inner.Current();
+        }
+    };
+
+    QueryTakeWhile(Inner inner, Predicate predicate) : inner(std::move(inner)), predicate(std::move(predicate)) {}
+
+    Cursor Open() const {
+        return Cursor(inner.Open(), &predicate);
+    }
+};
+
+template <typename First, typename Second>
+class QueryConcat {
+private:
+    First first;
+    Second second;
+
+public:
+    using ValueType = typename First::ValueType;
+    static_assert(std::is_same<ValueType, typename Second::ValueType>::value,
+                  "Concatenated queries must have the same element type");
+
+    class Cursor {
+    private:
+        typename First::Cursor first;
+        typename Second::Cursor second;
+        bool inSecond;
+
+    public:
+        Cursor(typename First::Cursor first, typename Second::Cursor second)
+            : first(std::move(first)), second(std::move(second)), inSecond(false) {}
+
+        bool MoveNext() {
+            if (!inSecond) {
+                if (first.MoveNext()) {
+                    return true;
+                }
+                inSecond = true;
+            }
+            return second.MoveNext();
+        }
+
+        const ValueType& Current() const {
+            return inSecond ? second.Current() : first.Current();
+        }
+    };
+
+    QueryConcat(First first, Second second) : first(std::move(first)), second(std::move(second)) {}
+
+    Cursor Open() const {
+        return Cursor(first.Open(), second.Open());
+    }
+};
+
+// Идёт по двум запросам параллельно и заканчивается вместе с более коротким
+template <typename First, typename Second, typename Combine>
+class QueryZip {
+private:
+    First first;
+    Second second;
+    Combine combine;
+
+public:
+    using ValueType = std::decay_t<std::invoke_result_t<const Combine&,
+        const typename First::ValueType&, const typename Second::ValueType&>>;
+
+    class Cursor {
+    private:
+        typename First::Cursor first;
+        typename Second::Cursor second;
+        const Combine* combine;
+        std::optional<ValueType> value;
+
+    public:
+        Cursor(typename First::Cursor first, typename Second::Cursor second, const Combine* combine)
+            : first(std::move(first)), second(std::move(second)), combine(combine) {}
+
+        bool MoveNext() {
+            if (!first.MoveNext() || !second.MoveNext()) {
+                return false;
+            }
+            value.emplace((*combine)(first.Current(), second.Current()));
+            return true;
+        }
+
+        const ValueType& Current() const {
+            return *value;
+        }
+    };
+
+    QueryZip(First first, Second second, Combine combine)
+        : first(std::move(first)), second(std::move(second)), combine(std::move(combine)) {}
+
+    Cursor Open() const {
+        return Cursor(first.Open(), second.Open(), &combine);
+    }
+};
+
+template <typename Stage>
+class Query {
+private:
+    template <typename>
+    friend class Query;
+
+    Stage stage;
+
+    template <typename Next>
+    static Query<Next> Chain(Next next) {
+        return Query<Next>(std::move(next));
+    }
+
+public:
+    using ValueType = typename Stage::ValueType;
+
+    explicit Query(Stage stage) : stage(std::move(stage)) {}
+
+    template <typename Predicate>
+    Query<QueryWhere<Stage, Predicate>> Where(Predicate predicate) const {
+        return Chain(QueryWhere<Stage, Predicate>(stage, std::move(predicate)));
+    }
+
+    template <typename Func>
+    Query<QueryMap<Stage, Func>> Map(Func func) const {
+        return Chain(QueryMap<Stage, Func>(stage, std::move(func)));
+    }
+
+    Query<QueryTake<Stage>> Take(IndexType count) const {
+        return Chain(QueryTake<Stage>(stage, count));
+    }
+
+    Query<QuerySkip<Stage>> Skip(IndexType count) const {
+        return Chain(QuerySkip<Stage>(stage, count));
+    }
+
+    template <typename Predicate>
+    Query<QueryTakeWhile<Stage, Predicate>> TakeWhile(Predicate predicate) const {
+        return Chain(QueryTakeWhile<Stage, Predicate>(stage, std::move(predicate)));
+    }
+
+    template <typename Other>
+    Query<QueryConcat<Stage, Other>> Concat(const Query<Other>& other) const {
+        return Chain(QueryConcat<Stage, Other>(stage, other.stage));
+    }
+
+    template <typename Other, typename Combine>
+    Query<QueryZip<Stage, Other, Combine>> Zip(const Query<Other>& other, Combine combine) const {
+        return Chain(QueryZip<Stage, Other, Combine>(stage, other.stage, std::move(combine)));
+    }
+
+    template <typename Other>
+    auto Zip(const Query<Other>& other) const {
+        return Zip(other, [](const ValueType& left, const typename Other::ValueType& right) {
+            return std::make_pair(left, right);
+        });
+    }
+
+    template <typename Visitor>
+    void ForEach(Visitor visit) const {
+        typename Stage::Cursor cursor = stage.Open();
+        while (cursor.MoveNext()) {
+            visit(cursor.Current());
+        }
+    }
+
+    template <typename Func, typename Accumulator>
+    Accumulator Reduce(Func func, Accumulator initial) const {
+        ForEach([&](const ValueType& item) { initial = func(initial, item); });
+        return initial;
+    }
+
+    IndexType Count() const {
+        IndexType count = 0;
+        ForEach([&](const ValueType&) { ++count; });
+        return count;
+    }
+
+    ArraySequence<ValueType> ToArraySequence() const {
+        ArraySequence<ValueType> result;
+        ForEach([&](const ValueType& item) { result.Append(item); });
+        return result;
+    }
+
+    ListSequence<ValueType> ToListSequence() const {
+        ListSequence<ValueType> result;
+        ForEach([&](const ValueType& item) { result.Append(item); });
+        return result;
+    }
+};
+
+template <typename T>
+Query<QuerySource<T>> From(const IEnumerable<T>& source) {
+    return Query<QuerySource<T>>(QuerySource<T>(source));
+}
+
+template <typename T, typename Allocator, int InlineCapacity>
+auto From(const ArraySequence<T, Allocator, InlineCapacity>& source) {
+    using Source = QueryArraySource<T, ArraySequence<T, Allocator, InlineCapacity>>;
+    return Query<Source>(Source(source));
+}
+
+template <typename T, typename Allocator, template <typename, typename> class List>
+auto From(const ListSequence<T, Allocator, List>& source) {
+    using Source = QueryListSource<T, ListSequence<T, Allocator, List>>;
+    return Query<Source>(Source(source));
+}
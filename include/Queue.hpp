@@ -1,75 +1,89 @@
+#pragma once
+
+#include <memory>
 #include <utility>
 #include "ListSequence.hpp"
 #include "Exceptions.hpp"
 #include "IEnumerable.hpp"
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>,
+         template <typename, typename> class List = LinkedList>
 class Queue : public IEnumerable<T> {
 private:
-    ListSequence<T> items;
+    using Cursor = typename ListSequence<T, Allocator, List>::Cursor;
+
+    ListSequence<T, Allocator, List> items;
 
     class QueueEnumerator : public IEnumerator<T> {
     private:
-        const ListSequence<T>& sequence;
-        int currentIndex;
-        T currentValue;
+        const ListSequence<T, Allocator, List>& sequence;
+        Cursor current;
+        bool isBeforeFirst;
 
     public:
-        explicit QueueEnumerator(const ListSequence<T>& seq)
+        explicit QueueEnumerator(const ListSequence<T, Allocator, List>& seq)
             : sequence(seq)
-            , currentIndex(-1)
-            , currentValue()
+            , current()
+            , isBeforeFirst(true)
         {}
 
         bool MoveNext() override
         {
-            if (currentIndex + 1 < sequence.GetLength())
+            if (isBeforeFirst)
             {
-                currentIndex++;
-                currentValue = sequence.Get(currentIndex);
-                return true;
+                current = sequence.First();
+                isBeforeFirst = false;
             }
-            return false;
+            else
+            {
+                current.MoveNext();
+            }
+            return current.IsValid();
         }
 
         const T& Current() const override
         {
-            if (currentIndex < 0 || currentIndex >= sequence.GetLength())
+            if (!current.IsValid())
             {
                 throw InvalidStateException("Enumerator is not in a valid position");
             }
-            return currentValue;
+            return current.Get();
         }
 
         void Reset() override
         {
-            currentIndex = -1;
+            current = Cursor();
+            isBeforeFirst = true;
         }
     };
 
 public:
     Queue() = default;
+    explicit Queue(const Allocator& allocator) : items(allocator) {}
 
     void Enqueue(const T& item)
     {
         items.Append(item);
     }
 
+    void Enqueue(T&& item)
+    {
+        items.Append(std::move(item));
+    }
+
+    template<typename... Args>
+    void Emplace(Args&&... args)
+    {
+        items.EmplaceBack(std::forward<Args>(args)...);
+    }
+
     Option<T> Dequeue()
     {
         if (items.GetLength() == 0)
         {
             return Option<T>::None();
         }
-        T value = items.GetFirst();
-        auto* newItems = new ListSequence<T>();
-        for (int i = 1; i < items.GetLength(); i++)
-        {
-            newItems->Append(items.Get(i));
-        }
-        items = *newItems;
-        delete newItems;
-        return Option<T>::Some(value);
+        return Option<T>::Some(items.RemoveFirst());
     }
 
     Option<T> Front() const
@@ -82,65 +96,61 @@ public:
         return items.GetLength() == 0;
     }
 
-    int GetSize() const
+    IndexType GetSize() const
     {
         return items.GetLength();
     }
 
+    Allocator GetAllocator() const
+    {
+        return items.GetAllocator();
+    }
+
     Sequence<T>* GetSequence() const
     {
-        return new ListSequence<T>(items);
+        return new ListSequence<T, Allocator, List>(items);
     }
 
-    Sequence<T>* Map(T (*func)(const T&)) const
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func
+    template<typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const
     {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < items.GetLength(); ++i)
-        {
-            result->Append(func(items.Get(i)));
-        }
-        return result;
+        return items.template Map<R>(func);
     }
 
-    Sequence<T>* Where(bool (*predicate)(const T&)) const
+    template<typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const
     {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < items.GetLength(); ++i)
-        {
-            T current = items.Get(i);
-            if (predicate(current))
-            {
-                result->Append(current);
-            }
-        }
-        return result;
+        return items.Where(predicate);
     }
 
-    T Reduce(T (*func)(const T&, const T&), const T& initial) const
+    template<typename Func>
+    T Reduce(Func func, const T& initial) const
     {
-        T result = initial;
-        for (int i = 0; i < items.GetLength(); ++i)
-        {
-            result = func(result, items.Get(i));
-        }
-        return result;
+        return items.Reduce(func, initial);
     }
 
-    Queue<T>* Concat(const Queue<T>* other) const
+    Queue<T, Allocator, List>* Concat(const Queue<T, Allocator, List>* other) const
     {
-        Queue<T>* result = new Queue<T>();
-        for (int i = 0; i < items.GetLength(); ++i)
+        Queue<T, Allocator, List>* result = new Queue<T, Allocator, List>(items.GetAllocator());
+        for (Cursor current = items.First(); current.IsValid(); current.MoveNext())
         {
-            result->Enqueue(items.Get(i));
+            result->Enqueue(current.Get());
         }
-        for (int i = 0; i < other->GetSize(); ++i)
+        for (Cursor current = other->items.First(); current.IsValid(); current.MoveNext())
         {
-            result->Enqueue(other->items.Get(i));
+            result->Enqueue(current.Get());
         }
         return result;
     }
 
-    Sequence<T>* GetSubsequence(int startIndex, int endIndex) const
+    // Переносит элементы other в конец очереди без копирования
+    void ConcatInPlace(Queue<T, Allocator, List>& other)
+    {
+        items.ConcatInPlace(other.items);
+    }
+
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const
     {
         return items.GetSubsequence(startIndex, endIndex);
     }
@@ -156,12 +166,14 @@ public:
             return false;
         }
 
-        for (int i = 0; i <= items.GetLength() - subseq->GetLength(); ++i)
+        Cursor start = items.First();
+        for (IndexType i = 0; i <= items.GetLength() - subseq->GetLength(); ++i, start.MoveNext())
         {
             bool match = true;
-            for (int j = 0; j < subseq->GetLength(); ++j)
+            Cursor current = start;
+            for (IndexType j = 0; j < subseq->GetLength(); ++j, current.MoveNext())
             {
-                if (!(items.Get(i + j) == subseq->Get(j)))
+                if (!(current.Get() == subseq->At(j)))
                 {
                     match = false;
                     break;
@@ -175,21 +187,22 @@ public:
         return false;
     }
 
-    std::pair<Queue<T>*, Queue<T>*> Split(bool (*predicate)(const T&)) const
+    template<typename Predicate>
+    std::pair<Queue<T, Allocator, List>*, Queue<T, Allocator, List>*> Split(Predicate predicate) const
     {
-        Queue<T>* matching = new Queue<T>();
-        Queue<T>* notMatching = new Queue<T>();
+        Queue<T, Allocator, List>* matching = new Queue<T, Allocator, List>(items.GetAllocator());
+        Queue<T, Allocator, List>* notMatching = new Queue<T, Allocator, List>(items.GetAllocator());
 
-        for (int i = 0; i < items.GetLength(); ++i)
+        for (Cursor current = items.First(); current.IsValid(); current.MoveNext())
         {
-            T current = items.Get(i);
-            if (predicate(current))
+            const T& item = current.Get();
+            if (predicate(item))
             {
-                matching->Enqueue(current);
+                matching->Enqueue(item);
             }
             else
             {
-                notMatching->Enqueue(current);
+                notMatching->Enqueue(item);
             }
         }
 
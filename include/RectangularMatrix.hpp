@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cmath>
+#include <utility>
+#include "BoundsCheck.hpp"
 #include "Complex.hpp"
 #include "DynamicArray.hpp"
 #include "Exceptions.hpp"
@@ -9,59 +11,87 @@
 template<typename T>
 class RectangularMatrix {
 private:
-    int rows;
-    int cols;
+    IndexType rows;
+    IndexType cols;
     DynamicArray<DynamicArray<T>> elements;
 
+    RectangularMatrix(IndexType rows, IndexType cols, DynamicArray<DynamicArray<T>>&& data)
+        : rows(rows), cols(cols), elements(std::move(data)) {}
+
+    // Доступ без проверки индексов для внутренних циклов
+    T& Cell(IndexType i, IndexType j) {
+        return elements.Data()[i].Data()[j];
+    }
+
+    const T& Cell(IndexType i, IndexType j) const {
+        return elements.Data()[i].Data()[j];
+    }
+
 public:
-    RectangularMatrix(int rows, int cols) : rows(rows), cols(cols), elements(rows) {
-        for (int i = 0; i < rows; ++i) {
-            DynamicArray<T> row(cols);
-            for (int j = 0; j < cols; ++j) {
-                row.Set(j, T());
-            }
-            elements.Set(i, row);
+    RectangularMatrix(IndexType rows, IndexType cols) : rows(rows), cols(cols) {
+        if (cols < 0) {
+            throw InvalidSizeException("Size cannot be negative");
+        }
+        elements.Reserve(rows);
+        for (IndexType i = 0; i < rows; ++i) {
+            elements.EmplaceBack(cols);
         }
     }
 
-    RectangularMatrix(const RectangularMatrix<T>& other) 
-        : rows(other.rows), cols(other.cols), elements(other.rows) {
-        for (int i = 0; i < rows; ++i) {
-            DynamicArray<T> row(other.elements.Get(i));
-            elements.Set(i, row);
+    RectangularMatrix(IndexType rows, IndexType cols, const T& value) : rows(rows), cols(cols) {
+        if (cols < 0) {
+            throw InvalidSizeException("Size cannot be negative");
+        }
+        elements.Reserve(rows);
+        for (IndexType i = 0; i < rows; ++i) {
+            elements.EmplaceBack(cols, value);
         }
     }
 
+    RectangularMatrix(const RectangularMatrix<T>& other) 
+        : rows(other.rows), cols(other.cols), elements(other.elements) {}
+
+    RectangularMatrix(RectangularMatrix<T>&& other) noexcept
+        : rows(other.rows), cols(other.cols), elements(std::move(other.elements)) {
+        other.rows = 0;
+        other.cols = 0;
+    }
+
     RectangularMatrix<T>& operator=(const RectangularMatrix<T>& other) {
         if (this != &other) {
             rows = other.rows;
             cols = other.cols;
-            elements = DynamicArray<DynamicArray<T>>(rows);
-            for (int i = 0; i < rows; ++i) {
-                DynamicArray<T> row(other.elements.Get(i));
-                elements.Set(i, row);
-            }
+            elements = other.elements;
         }
         return *this;
     }
 
-    int GetRows() const { return rows; }
-    int GetCols() const { return cols; }
+    RectangularMatrix<T>& operator=(RectangularMatrix<T>&& other) noexcept {
+        if (this != &other) {
+            rows = other.rows;
+            cols = other.cols;
+            elements = std::move(other.elements);
+            other.rows = 0;
+            other.cols = 0;
+        }
+        return *this;
+    }
+
+    IndexType GetRows() const { return rows; }
+    IndexType GetCols() const { return cols; }
 
-    T Get(int i, int j) const {
-        if (i < 0 || i >= rows || j < 0 || j >= cols) {
+    T Get(IndexType i, IndexType j) const {
+        if (BoundsCheckEnabled && (i < 0 || i >= rows || j < 0 || j >= cols)) {
             throw IndexOutOfRangeException("Index out of range");
         }
-        return elements.Get(i).Get(j);
+        return Cell(i, j);
     }
 
-    void Set(int i, int j, const T& value) {
-        if (i < 0 || i >= rows || j < 0 || j >= cols) {
+    void Set(IndexType i, IndexType j, const T& value) {
+        if (BoundsCheckEnabled && (i < 0 || i >= rows || j < 0 || j >= cols)) {
             throw IndexOutOfRangeException("Index out of range");
         }
-        DynamicArray<T> row = elements.Get(i);
-        row.Set(j, value);
-        elements.Set(i, row);
+        Cell(i, j) = value;
     }
 
     RectangularMatrix<T> operator+(const RectangularMatrix<T>& other) const {
@@ -69,113 +99,110 @@ public:
             throw InvalidArgumentException("Matrices must have the same dimensions for addition");
         }
 
-        RectangularMatrix<T> result(rows, cols);
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result.Set(i, j, Get(i, j) + other.Get(i, j));
+        DynamicArray<DynamicArray<T>> data;
+        data.Reserve(rows);
+        for (IndexType i = 0; i < rows; ++i) {
+            DynamicArray<T>& row = data.EmplaceBack();
+            row.Reserve(cols);
+            for (IndexType j = 0; j < cols; ++j) {
+                row.EmplaceBack(Cell(i, j) + other.Cell(i, j));
             }
         }
-        return result;
+        return RectangularMatrix<T>(rows, cols, std::move(data));
     }
 
 
     RectangularMatrix<T> operator*(const T& scalar) const {
-        RectangularMatrix<T> result(rows, cols);
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result.Set(i, j, Get(i, j) * scalar);
+        DynamicArray<DynamicArray<T>> data;
+        data.Reserve(rows);
+        for (IndexType i = 0; i < rows; ++i) {
+            DynamicArray<T>& row = data.EmplaceBack();
+            row.Reserve(cols);
+            for (IndexType j = 0; j < cols; ++j) {
+                row.EmplaceBack(Cell(i, j) * scalar);
             }
         }
-        return result;
+        return RectangularMatrix<T>(rows, cols, std::move(data));
     }
 
     double Norm() const {
         T sum = T();
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                sum = sum + Get(i, j) * Get(i, j);
+        for (IndexType i = 0; i < rows; ++i) {
+            for (IndexType j = 0; j < cols; ++j) {
+                sum = sum + Cell(i, j) * Cell(i, j);
             }
         }
         return std::sqrt(std::abs(sum));
     }
 
-    void MultiplyRow(int row, const T& scalar) {
+    void MultiplyRow(IndexType row, const T& scalar) {
         if (row < 0 || row >= rows) {
             throw IndexOutOfRangeException("Invalid row index");
         }
-        for (int j = 0; j < cols; ++j) {
-            Set(row, j, Get(row, j) * scalar);
+        for (IndexType j = 0; j < cols; ++j) {
+            Cell(row, j) = Cell(row, j) * scalar;
         }
     }
 
-    void MultiplyColumn(int col, const T& scalar) {
+    void MultiplyColumn(IndexType col, const T& scalar) {
         if (col < 0 || col >= cols) {
             throw IndexOutOfRangeException("Invalid column index");
         }
-        for (int i = 0; i < rows; ++i) {
-            Set(i, col, Get(i, col) * scalar);
+        for (IndexType i = 0; i < rows; ++i) {
+            Cell(i, col) = Cell(i, col) * scalar;
         }
     }
 
-    void AddRowMultiple(int destRow, int srcRow, const T& scalar) {
+    void AddRowMultiple(IndexType destRow, IndexType srcRow, const T& scalar) {
         if (destRow < 0 || destRow >= rows || srcRow < 0 || srcRow >= rows) {
             throw IndexOutOfRangeException("Invalid row index");
         }
-        for (int j = 0; j < cols; ++j) {
-            Set(destRow, j, Get(destRow, j) + Get(srcRow, j) * scalar);
+        for (IndexType j = 0; j < cols; ++j) {
+            Cell(destRow, j) = Cell(destRow, j) + Cell(srcRow, j) * scalar;
         }
     }
 
-    void AddColumnMultiple(int destCol, int srcCol, const T& scalar) {
+    void AddColumnMultiple(IndexType destCol, IndexType srcCol, const T& scalar) {
         if (destCol < 0 || destCol >= cols || srcCol < 0 || srcCol >= cols) {
             throw IndexOutOfRangeException("Invalid column index");
         }
-        for (int i = 0; i < rows; ++i) {
-            Set(i, destCol, Get(i, destCol) + Get(i, srcCol) * scalar);
+        for (IndexType i = 0; i < rows; ++i) {
+            Cell(i, destCol) = Cell(i, destCol) + Cell(i, srcCol) * scalar;
         }
     }
 
-    void SwapRows(int row1, int row2) {
+    void SwapRows(IndexType row1, IndexType row2) {
         if (row1 < 0 || row1 >= rows || row2 < 0 || row2 >= rows) {
             throw IndexOutOfRangeException("Invalid row index");
         }
-        for (int j = 0; j < cols; ++j) {
-            T temp = Get(row1, j);
-            Set(row1, j, Get(row2, j));
-            Set(row2, j, temp);
-        }
+        std::swap(elements.Data()[row1], elements.Data()[row2]);
     }
 
-    void SwapColumns(int col1, int col2) {
+    void SwapColumns(IndexType col1, IndexType col2) {
         if (col1 < 0 || col1 >= cols || col2 < 0 || col2 >= cols) {
             throw IndexOutOfRangeException("Invalid column index");
         }
-        for (int i = 0; i < rows; ++i) {
-            T temp = Get(i, col1);
-            Set(i, col1, Get(i, col2));
-            Set(i, col2, temp);
+        for (IndexType i = 0; i < rows; ++i) {
+            std::swap(Cell(i, col1), Cell(i, col2));
         }
     }
 
-    Vector<T> GetRow(int row) const {
+    Vector<T> GetRow(IndexType row) const {
         if (row < 0 || row >= rows) {
             throw IndexOutOfRangeException("Invalid row index");
         }
-        Vector<T> result(cols);
-        for (int j = 0; j < cols; ++j) {
-            result.Set(j, Get(row, j));
-        }
-        return result;
+        return Vector<T>(elements.Data()[row]);
     }
 
-    Vector<T> GetColumn(int col) const {
+    Vector<T> GetColumn(IndexType col) const {
         if (col < 0 || col >= cols) {
             throw IndexOutOfRangeException("Invalid column index");
         }
-        Vector<T> result(rows);
-        for (int i = 0; i < rows; ++i) {
-            result.Set(i, Get(i, col));
+        DynamicArray<T> column;
+        column.Reserve(rows);
+        for (IndexType i = 0; i < rows; ++i) {
+            column.PushBack(Cell(i, col));
         }
-        return result;
+        return Vector<T>(std::move(column));
     }
 };
\ No newline at end of file
@@ -0,0 +1,514 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include "SequenceOps.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+
+// Верёвка: сбалансированное (AVL по высоте) дерево неизменяемых узлов,
+// листья которого - непрерывные массивы до LeafCapacity элементов.
+// Узлы разделяются между верёвками, поэтому копирование, Concat, Slice,
+// GetSubsequence и вставка стоят O(log N) и не копируют сами элементы,
+// кроме листа на границе разреза и не более MergeCapacity элементов при
+// слиянии соседних мелких листьев. Поэтому Append и Prepend по одному
+// элементу - O(log N), а листья, собранные так, не длиннее MergeCapacity
+template <typename T, typename Allocator = std::allocator<T>>
+class RopeSequence : public SequenceOps<T, RopeSequence<T, Allocator>> {
+public:
+    static constexpr IndexType LeafCapacity = sizeof(T) * 16 >= 2048 ? 16 : 2048 / sizeof(T);
+    // Соседние листья сливаются в один, только если вместе не длиннее этого
+    static constexpr IndexType MergeCapacity = LeafCapacity < 32 ? LeafCapacity : 32;
+
+private:
+    struct RopeNode;
+    using NodePtr = std::shared_ptr<const RopeNode>;
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<RopeNode>;
+
+    struct RopeNode {
+        IndexType length;
+        int height;
+        NodePtr left;
+        NodePtr right;
+        // Элементы листа; у внутренних узлов пусто
+        DynamicArray<T, Allocator> items;
+
+        explicit RopeNode(DynamicArray<T, Allocator>&& items)
+            : length(items.GetSize()), height(0), items(std::move(items)) {}
+
+        RopeNode(NodePtr left, NodePtr right, const Allocator& allocator)
+            : length(left->length + right->length),
+              height(1 + std::max(left->height, right->height)),
+              left(std::move(left)), right(std::move(right)), items(allocator) {}
+
+        bool IsLeaf() const {
+            return !left;
+        }
+    };
+
+    // Map<R> собирает верёвку другого типа через её Builder
+    template <typename, typename>
+    friend class RopeSequence;
+
+    // Собирает верёвку из элементов, поступающих по одному
+    class Builder {
+    private:
+        const RopeSequence& owner;
+        DynamicArray<T, Allocator> chunk;
+        NodePtr root;
+
+        void Flush() {
+            if (chunk.GetSize() > 0) {
+                root = owner.Join(root, owner.MakeLeaf(std::move(chunk)));
+                chunk = DynamicArray<T, Allocator>(owner.allocator);
+            }
+        }
+
+    public:
+        explicit Builder(const RopeSequence& owner) : owner(owner), chunk(owner.allocator) {}
+
+        void Add(const T& item) {
+            if (chunk.GetSize() == LeafCapacity) {
+                Flush();
+            }
+            chunk.PushBack(item);
+        }
+
+        void Add(T&& item) {
+            if (chunk.GetSize() == LeafCapacity) {
+                Flush();
+            }
+            chunk.PushBack(std::move(item));
+        }
+
+        void AddAll(const Sequence<T>* source) {
+            IEnumerator<T>* enumerator = source->GetEnumerator();
+            while (enumerator->MoveNext()) {
+                Add(enumerator->Current());
+            }
+            delete enumerator;
+        }
+
+        NodePtr Finish() {
+            Flush();
+            return root;
+        }
+    };
+
+    class RopeEnumerator : public IEnumerator<T> {
+    private:
+        const RopeSequence<T, Allocator>& sequence;
+        const RopeNode* leaf;
+        IndexType leafStart;
+        IndexType currentIndex;
+
+    public:
+        explicit RopeEnumerator(const RopeSequence<T, Allocator>& sequence)
+            : sequence(sequence), leaf(nullptr), leafStart(0), currentIndex(-1) {}
+
+        bool MoveNext() override {
+            if (currentIndex + 1 >= sequence.GetLength()) {
+                return false;
+            }
+            ++currentIndex;
+            if (!leaf || currentIndex >= leafStart + leaf->length) {
+                leaf = sequence.LeafAt(currentIndex, leafStart);
+            }
+            return true;
+        }
+
+        const T& Current() const override {
+            if (currentIndex < 0 || currentIndex >= sequence.GetLength()) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return leaf->items.Data()[currentIndex - leafStart];
+        }
+
+        void Reset() override {
+            leaf = nullptr;
+            currentIndex = -1;
+        }
+    };
+
+    Allocator allocator;
+    NodePtr root;
+
+    RopeSequence(NodePtr root, const Allocator& allocator) : allocator(allocator), root(std::move(root)) {}
+
+    static int Height(const NodePtr& node) {
+        return node ? node->height : -1;
+    }
+
+    NodePtr MakeLeaf(DynamicArray<T, Allocator>&& items) const {
+        return std::allocate_shared<RopeNode>(NodeAllocator(allocator), std::move(items));
+    }
+
+    NodePtr MakeNode(const NodePtr& left, const NodePtr& right) const {
+        return std::allocate_shared<RopeNode>(NodeAllocator(allocator), left, right, allocator);
+    }
+
+    // Соединяет поддеревья с разницей высот не больше двух
+    NodePtr Balance(const NodePtr& left, const NodePtr& right) const {
+        if (Height(left) > Height(right) + 1) {
+            if (Height(left->left) >= Height(left->right)) {
+                return MakeNode(left->left, MakeNode(left->right, right));
+            }
+            return MakeNode(MakeNode(left->left, left->right->left),
+                            MakeNode(left->right->right, right));
+        }
+        if (Height(right) > Height(left) + 1) {
+            if (Height(right->right) >= Height(right->left)) {
+                return MakeNode(MakeNode(left, right->left), right->right);
+            }
+            return MakeNode(MakeNode(left, right->left->left),
+                            MakeNode(right->left->right, right->right));
+        }
+        return MakeNode(left, right);
+    }
+
+    // Конкатенация за O(|h(left) - h(right)|); соседние мелкие листья сливаются.
+    // Порог MergeCapacity, а не LeafCapacity: иначе добавление по одному
+    // элементу каждый раз копировало бы растущий крайний лист целиком
+    NodePtr Join(const NodePtr& left, const NodePtr& right) const {
+        if (!left) {
+            return right;
+        }
+        if (!right) {
+            return left;
+        }
+        if (left->IsLeaf() && right->IsLeaf() && left->length + right->length <= MergeCapacity) {
+            DynamicArray<T, Allocator> merged(allocator);
+            merged.Reserve(left->length + right->length);
+            merged.InsertRange(0, left->items.Data(), left->length);
+            merged.InsertRange(left->length, right->items.Data(), right->length);
+            return MakeLeaf(std::move(merged));
+        }
+        if (Height(left) > Height(right) + 1) {
+            return Balance(left->left, Join(left->right, right));
+        }
+        if (Height(right) > Height(left) + 1) {
+            return Balance(Join(left, right->left), right->right);
+        }
+        return MakeNode(left, right);
+    }
+
+    // Делит дерево на первые index элементов и остальные
+    std::pair<NodePtr, NodePtr> SplitAt(const NodePtr& node, IndexType index) const {
+        if (!node || index <= 0) {
+            return std::make_pair(NodePtr(), node);
+        }
+        if (index >= node->length) {
+            return std::make_pair(node, NodePtr());
+        }
+        if (node->IsLeaf()) {
+            DynamicArray<T, Allocator> head(node->items.Data(), index, allocator);
+            DynamicArray<T, Allocator> tail(node->items.Data() + index, node->length - index, allocator);
+            return std::make_pair(MakeLeaf(std::move(head)), MakeLeaf(std::move(tail)));
+        }
+        IndexType leftLength = node->left->length;
+        if (index <= leftLength) {
+            std::pair<NodePtr, NodePtr> parts = SplitAt(node->left, index);
+            return std::make_pair(parts.first, Join(parts.second, node->right));
+        }
+        std::pair<NodePtr, NodePtr> parts = SplitAt(node->right, index - leftLength);
+        return std::make_pair(Join(node->left, parts.first), parts.second);
+    }
+
+    // Лист, содержащий index, и индекс его первого элемента
+    const RopeNode* LeafAt(IndexType index, IndexType& leafStart) const {
+        const RopeNode* node = root.get();
+        leafStart = 0;
+        while (!node->IsLeaf()) {
+            if (index - leafStart < node->left->length) {
+                node = node->left.get();
+            } else {
+                leafStart += node->left->length;
+                node = node->right.get();
+            }
+        }
+        return node;
+    }
+
+    const T& Cell(IndexType index) const {
+        IndexType leafStart;
+        const RopeNode* leaf = LeafAt(index, leafStart);
+        return leaf->items.Data()[index - leafStart];
+    }
+
+    template <typename Visitor>
+    static void Visit(const RopeNode* node, Visitor& visit) {
+        if (!node) {
+            return;
+        }
+        if (node->IsLeaf()) {
+            const T* data = node->items.Data();
+            for (IndexType i = 0; i < node->length; ++i) {
+                visit(data[i]);
+            }
+            return;
+        }
+        Visit(node->left.get(), visit);
+        Visit(node->right.get(), visit);
+    }
+
+    // Узлы другой верёвки того же типа разделяются, остальные последовательности копируются
+    NodePtr Adopt(const Sequence<T>* other) const {
+        const RopeSequence<T, Allocator>* rope = dynamic_cast<const RopeSequence<T, Allocator>*>(other);
+        if (rope) {
+            return rope->root;
+        }
+        Builder builder(*this);
+        builder.AddAll(other);
+        return builder.Finish();
+    }
+
+    RopeSequence<T, Allocator>* Wrap(NodePtr node) const {
+        return new RopeSequence<T, Allocator>(std::move(node), allocator);
+    }
+
+    template <typename... Args>
+    void InsertNode(IndexType index, Args&&... args) {
+        if (index < 0 || index > GetLength()) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        DynamicArray<T, Allocator> single(allocator);
+        single.EmplaceBack(std::forward<Args>(args)...);
+        std::pair<NodePtr, NodePtr> parts = SplitAt(root, index);
+        root = Join(Join(parts.first, MakeLeaf(std::move(single))), parts.second);
+    }
+
+public:
+    RopeSequence() : allocator(), root() {}
+    explicit RopeSequence(const Allocator& allocator) : allocator(allocator), root() {}
+    RopeSequence(const T* items, IndexType count, const Allocator& allocator = Allocator())
+        : allocator(allocator), root() {
+        if (count < 0) {
+            throw InvalidSizeException("Count cannot be negative");
+        }
+        Builder builder(*this);
+        for (IndexType i = 0; i < count; ++i) {
+            builder.Add(items[i]);
+        }
+        root = builder.Finish();
+    }
+
+    // Копия разделяет узлы с оригиналом
+    RopeSequence(const RopeSequence& other) = default;
+    RopeSequence(RopeSequence&& other) = default;
+    RopeSequence& operator=(const RopeSequence& other) = default;
+    RopeSequence& operator=(RopeSequence&& other) = default;
+
+    T Get(IndexType index) const override {
+        return At(index);
+    }
+
+    T GetFirst() const override {
+        return FirstRef();
+    }
+
+    T GetLast() const override {
+        return LastRef();
+    }
+
+    const T& At(IndexType index) const override {
+        if (index < 0 || index >= GetLength()) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return Cell(index);
+    }
+
+    const T& FirstRef() const override {
+        if (GetLength() == 0) {
+            throw EmptySequenceException();
+        }
+        return Cell(0);
+    }
+
+    const T& LastRef() const override {
+        if (GetLength() == 0) {
+            throw EmptySequenceException();
+        }
+        return Cell(GetLength() - 1);
+    }
+
+    Option<T> TryGet(IndexType index) const override {
+        if (index < 0 || index >= GetLength()) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(index));
+    }
+
+    Option<T> TryGetFirst() const override {
+        if (GetLength() == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(0));
+    }
+
+    Option<T> TryGetLast() const override {
+        if (GetLength() == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(GetLength() - 1));
+    }
+
+    IndexType GetLength() const override {
+        return root ? root->length : 0;
+    }
+
+    int GetHeight() const {
+        return Height(root);
+    }
+
+    Allocator GetAllocator() const {
+        return allocator;
+    }
+
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const override {
+        if (startIndex < 0 || endIndex >= GetLength() || startIndex > endIndex) {
+            throw IndexOutOfRangeException("Invalid subsequence indices");
+        }
+        NodePtr prefix = SplitAt(root, endIndex + 1).first;
+        return Wrap(SplitAt(prefix, startIndex).second);
+    }
+
+    void Append(const T& item) override {
+        InsertNode(GetLength(), item);
+    }
+
+    void Append(T&& item) override {
+        InsertNode(GetLength(), std::move(item));
+    }
+
+    void Prepend(const T& item) override {
+        InsertNode(0, item);
+    }
+
+    void Prepend(T&& item) override {
+        InsertNode(0, std::move(item));
+    }
+
+    void InsertAt(const T& item, IndexType index) override {
+        InsertNode(index, item);
+    }
+
+    void InsertAt(T&& item, IndexType index) override {
+        InsertNode(index, std::move(item));
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        InsertNode(GetLength(), std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        InsertNode(0, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void EmplaceAt(IndexType index, Args&&... args) {
+        InsertNode(index, std::forward<Args>(args)...);
+    }
+
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func
+    template <typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const {
+        using Result = MapResult<R, Func, T>;
+        using ResultRope = RopeSequence<Result, ReboundAllocator<Allocator, Result>>;
+        auto* result = new ResultRope(ReboundAllocator<Allocator, Result>(allocator));
+        typename ResultRope::Builder builder(*result);
+        auto visit = [&](const T& item) { builder.Add(func(item)); };
+        Visit(root.get(), visit);
+        result->root = builder.Finish();
+        return result;
+    }
+
+    template <typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const {
+        Builder builder(*this);
+        auto visit = [&](const T& item) {
+            if (predicate(item)) {
+                builder.Add(item);
+            }
+        };
+        Visit(root.get(), visit);
+        return Wrap(builder.Finish());
+    }
+
+    template <typename Func>
+    T Reduce(Func func, const T& initial) const {
+        T result = initial;
+        auto visit = [&](const T& item) { result = func(result, item); };
+        Visit(root.get(), visit);
+        return result;
+    }
+
+    Sequence<T>* Slice(IndexType i, IndexType N, const Sequence<T>* s = nullptr) const override {
+        IndexType length = GetLength();
+
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+
+        NodePtr prefix = SplitAt(root, i).first;
+        NodePtr suffix = SplitAt(root, i + N).second;
+        NodePtr middle = s != nullptr ? Adopt(s) : NodePtr();
+        return Wrap(Join(Join(prefix, middle), suffix));
+    }
+
+    template <typename Func>
+    Sequence<T>* FlatMap(Func func) const {
+        Builder builder(*this);
+        auto visit = [&](const T& item) {
+            Sequence<T>* subseq = func(item);
+            builder.AddAll(subseq);
+            delete subseq;
+        };
+        Visit(root.get(), visit);
+        return Wrap(builder.Finish());
+    }
+
+    template <typename Predicate>
+    Option<T> Find(Predicate predicate) const {
+        IEnumerator<T>* enumerator = GetEnumerator();
+        while (enumerator->MoveNext()) {
+            if (predicate(enumerator->Current())) {
+                Option<T> found = Option<T>::Some(enumerator->Current());
+                delete enumerator;
+                return found;
+            }
+        }
+        delete enumerator;
+        return Option<T>::None();
+    }
+
+    template <typename Predicate>
+    std::pair<Sequence<T>*, Sequence<T>*> Split(Predicate predicate) const {
+        Builder matching(*this);
+        Builder notMatching(*this);
+        auto visit = [&](const T& item) {
+            if (predicate(item)) {
+                matching.Add(item);
+            } else {
+                notMatching.Add(item);
+            }
+        };
+        Visit(root.get(), visit);
+        return std::make_pair(Wrap(matching.Finish()), Wrap(notMatching.Finish()));
+    }
+
+    Sequence<T>* Concat(const Sequence<T>* other) const override {
+        return Wrap(Join(root, Adopt(other)));
+    }
+
+    IEnumerator<T>* GetEnumerator() const override {
+        return new RopeEnumerator(*this);
+    }
+};
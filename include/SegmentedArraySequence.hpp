@@ -0,0 +1,465 @@
+#pragma once
+#include <memory>
+#include <utility>
+#include "SequenceOps.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+
+// Последовательность на блоках фиксированного размера. Таблица указателей
+// на блоки растёт как DynamicArray, но сами элементы никогда не переезжают:
+// добавление в конец не копирует буфер, а адреса элементов стабильны, пока
+// их не сдвигает вставка или удаление в середине. Размер блока - степень
+// двойки около 4 КБ, поэтому доступ по индексу - сдвиг и маска
+template <typename T, typename Allocator = std::allocator<T>>
+class SegmentedArraySequence : public SequenceOps<T, SegmentedArraySequence<T, Allocator>> {
+private:
+    static constexpr int ComputeChunkShift() {
+        IndexType target = sizeof(T) * 16 >= 4096 ? 16 : static_cast<IndexType>(4096 / sizeof(T));
+        int shift = 0;
+        while ((IndexType(2) << shift) <= target) {
+            ++shift;
+        }
+        return shift;
+    }
+
+public:
+    static constexpr int ChunkShift = ComputeChunkShift();
+    static constexpr IndexType ChunkSize = IndexType(1) << ChunkShift;
+
+private:
+    static constexpr IndexType ChunkMask = ChunkSize - 1;
+
+    using ElementTraits = std::allocator_traits<Allocator>;
+    using ChunkTableAllocator = typename ElementTraits::template rebind_alloc<T*>;
+
+    Allocator allocator;
+    DynamicArray<T*, ChunkTableAllocator> chunks;
+    IndexType size;
+
+    class SegmentedArrayEnumerator : public IEnumerator<T> {
+    private:
+        const SegmentedArraySequence<T, Allocator>& sequence;
+        IndexType currentIndex;
+
+    public:
+        explicit SegmentedArrayEnumerator(const SegmentedArraySequence<T, Allocator>& sequence)
+            : sequence(sequence), currentIndex(-1) {}
+
+        bool MoveNext() override {
+            if (currentIndex + 1 < sequence.size) {
+                currentIndex++;
+                return true;
+            }
+            return false;
+        }
+
+        const T& Current() const override {
+            if (currentIndex < 0 || currentIndex >= sequence.size) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return sequence.Cell(currentIndex);
+        }
+
+        void Reset() override {
+            currentIndex = -1;
+        }
+    };
+
+    T& Cell(IndexType index) {
+        return chunks.Data()[index >> ChunkShift][index & ChunkMask];
+    }
+
+    const T& Cell(IndexType index) const {
+        return chunks.Data()[index >> ChunkShift][index & ChunkMask];
+    }
+
+    // Место под элемент с индексом size; новый блок выделяется только на границе
+    T* EndSlot() {
+        if (size == chunks.GetSize() * ChunkSize) {
+            T* chunk = ElementTraits::allocate(allocator, ChunkSize);
+            try {
+                chunks.PushBack(chunk);
+            } catch (...) {
+                ElementTraits::deallocate(allocator, chunk, ChunkSize);
+                throw;
+            }
+        }
+        return &Cell(size);
+    }
+
+    // Оставляет не больше одного пустого блока, чтобы чередование удалений
+    // и добавлений на границе блока не выделяло память каждый раз
+    void ReleaseSpareChunks() {
+        while (chunks.GetSize() * ChunkSize > size + ChunkSize) {
+            ElementTraits::deallocate(allocator, chunks.Data()[chunks.GetSize() - 1], ChunkSize);
+            chunks.PopBack();
+        }
+    }
+
+    void FreeChunks() {
+        Clear();
+        while (chunks.GetSize() > 0) {
+            ElementTraits::deallocate(allocator, chunks.Data()[chunks.GetSize() - 1], ChunkSize);
+            chunks.PopBack();
+        }
+    }
+
+    // Обход всех элементов по порядку, блок за блоком
+    template <typename Visitor>
+    void Visit(Visitor visit) const {
+        for (IndexType chunk = 0; chunk * ChunkSize < size; ++chunk) {
+            const T* data = chunks.Data()[chunk];
+            IndexType count = size - chunk * ChunkSize < ChunkSize ? size - chunk * ChunkSize : ChunkSize;
+            for (IndexType i = 0; i < count; ++i) {
+                visit(data[i]);
+            }
+        }
+    }
+
+    SegmentedArraySequence<T, Allocator>* CreateEmpty() const {
+        return new SegmentedArraySequence<T, Allocator>(allocator);
+    }
+
+public:
+    SegmentedArraySequence() : allocator(), chunks(), size(0) {}
+    explicit SegmentedArraySequence(const Allocator& allocator)
+        : allocator(allocator), chunks(ChunkTableAllocator(allocator)), size(0) {}
+    SegmentedArraySequence(const T* items, IndexType count, const Allocator& allocator = Allocator())
+        : SegmentedArraySequence(allocator) {
+        if (count < 0) {
+            throw InvalidSizeException("Count cannot be negative");
+        }
+        for (IndexType i = 0; i < count; ++i) {
+            EmplaceBack(items[i]);
+        }
+    }
+
+    SegmentedArraySequence(const SegmentedArraySequence& other)
+        : SegmentedArraySequence(ElementTraits::select_on_container_copy_construction(other.allocator)) {
+        other.Visit([&](const T& item) { EmplaceBack(item); });
+    }
+
+    SegmentedArraySequence(SegmentedArraySequence&& other) noexcept
+        : allocator(std::move(other.allocator)), chunks(std::move(other.chunks)), size(other.size) {
+        other.size = 0;
+    }
+
+    SegmentedArraySequence& operator=(const SegmentedArraySequence& other) {
+        if (this != &other) {
+            Clear();
+            other.Visit([&](const T& item) { EmplaceBack(item); });
+        }
+        return *this;
+    }
+
+    SegmentedArraySequence& operator=(SegmentedArraySequence&& other) {
+        if (this == &other) {
+            return *this;
+        }
+        FreeChunks();
+        if (ElementTraits::propagate_on_container_move_assignment::value || allocator == other.allocator) {
+            if (ElementTraits::propagate_on_container_move_assignment::value) {
+                allocator = std::move(other.allocator);
+            }
+            chunks = std::move(other.chunks);
+            size = other.size;
+            other.size = 0;
+        } else {
+            for (IndexType i = 0; i < other.size; ++i) {
+                EmplaceBack(std::move(other.Cell(i)));
+            }
+            other.Clear();
+        }
+        return *this;
+    }
+
+    ~SegmentedArraySequence() {
+        FreeChunks();
+    }
+
+    T Get(IndexType index) const override {
+        return At(index);
+    }
+
+    T GetFirst() const override {
+        return FirstRef();
+    }
+
+    T GetLast() const override {
+        return LastRef();
+    }
+
+    const T& At(IndexType index) const override {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return Cell(index);
+    }
+
+    const T& FirstRef() const override {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        return Cell(0);
+    }
+
+    const T& LastRef() const override {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        return Cell(size - 1);
+    }
+
+    Option<T> TryGet(IndexType index) const override {
+        if (index < 0 || index >= size) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(index));
+    }
+
+    Option<T> TryGetFirst() const override {
+        if (size == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(0));
+    }
+
+    Option<T> TryGetLast() const override {
+        if (size == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Cell(size - 1));
+    }
+
+    IndexType GetLength() const override {
+        return size;
+    }
+
+    // Выделенная ёмкость, всегда кратна ChunkSize
+    IndexType GetCapacity() const {
+        return chunks.GetSize() * ChunkSize;
+    }
+
+    // Выделяет блоки под count элементов сразу; элементы при этом не
+    // переезжают, растёт только таблица блоков
+    void Reserve(IndexType count) {
+        if (count < 0) {
+            throw InvalidSizeException("Capacity cannot be negative");
+        }
+        IndexType needed = (count + ChunkMask) >> ChunkShift;
+        chunks.Reserve(needed);
+        while (chunks.GetSize() < needed) {
+            T* chunk = ElementTraits::allocate(allocator, ChunkSize);
+            try {
+                chunks.PushBack(chunk);
+            } catch (...) {
+                ElementTraits::deallocate(allocator, chunk, ChunkSize);
+                throw;
+            }
+        }
+    }
+
+    Allocator GetAllocator() const {
+        return allocator;
+    }
+
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const override {
+        if (startIndex < 0 || endIndex >= size || startIndex > endIndex) {
+            throw IndexOutOfRangeException("Invalid subsequence indices");
+        }
+        SegmentedArraySequence<T, Allocator>* result = CreateEmpty();
+        for (IndexType i = startIndex; i <= endIndex; ++i) {
+            result->EmplaceBack(Cell(i));
+        }
+        return result;
+    }
+
+    void Append(const T& item) override {
+        EmplaceBack(item);
+    }
+
+    void Append(T&& item) override {
+        EmplaceBack(std::move(item));
+    }
+
+    void Prepend(const T& item) override {
+        EmplaceAt(0, item);
+    }
+
+    void Prepend(T&& item) override {
+        EmplaceAt(0, std::move(item));
+    }
+
+    void InsertAt(const T& item, IndexType index) override {
+        EmplaceAt(index, item);
+    }
+
+    void InsertAt(T&& item, IndexType index) override {
+        EmplaceAt(index, std::move(item));
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        ElementTraits::construct(allocator, EndSlot(), std::forward<Args>(args)...);
+        ++size;
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        EmplaceAt(0, std::forward<Args>(args)...);
+    }
+
+    // Вставка в середину сдвигает хвост на одну позицию через границы блоков
+    template <typename... Args>
+    void EmplaceAt(IndexType index, Args&&... args) {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        if (index == size) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return;
+        }
+        T value(std::forward<Args>(args)...);
+        EmplaceBack(std::move(Cell(size - 1)));
+        for (IndexType i = size - 2; i > index; --i) {
+            Cell(i) = std::move(Cell(i - 1));
+        }
+        Cell(index) = std::move(value);
+    }
+
+    T RemoveAt(IndexType index) {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        T value = std::move(Cell(index));
+        for (IndexType i = index; i < size - 1; ++i) {
+            Cell(i) = std::move(Cell(i + 1));
+        }
+        ElementTraits::destroy(allocator, &Cell(size - 1));
+        --size;
+        ReleaseSpareChunks();
+        return value;
+    }
+
+    T RemoveLast() {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        return RemoveAt(size - 1);
+    }
+
+    // Уничтожает элементы, но оставляет блоки для повторного заполнения
+    void Clear() {
+        for (IndexType i = 0; i < size; ++i) {
+            ElementTraits::destroy(allocator, &Cell(i));
+        }
+        size = 0;
+    }
+
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func
+    template <typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const {
+        using Result = MapResult<R, Func, T>;
+        using ResultAllocator = ReboundAllocator<Allocator, Result>;
+        auto* result = new SegmentedArraySequence<Result, ResultAllocator>(ResultAllocator(allocator));
+        result->Reserve(size);
+        Visit([&](const T& item) { result->EmplaceBack(func(item)); });
+        return result;
+    }
+
+    template <typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const {
+        SegmentedArraySequence<T, Allocator>* result = CreateEmpty();
+        Visit([&](const T& item) {
+            if (predicate(item)) {
+                result->EmplaceBack(item);
+            }
+        });
+        return result;
+    }
+
+    template <typename Func>
+    T Reduce(Func func, const T& initial) const {
+        T result = initial;
+        Visit([&](const T& item) { result = func(result, item); });
+        return result;
+    }
+
+    Sequence<T>* Slice(IndexType i, IndexType N, const Sequence<T>* s = nullptr) const override {
+        IndexType length = size;
+
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+
+        SegmentedArraySequence<T, Allocator>* result = CreateEmpty();
+        for (IndexType j = 0; j < i; ++j) {
+            result->EmplaceBack(Cell(j));
+        }
+        if (s != nullptr) {
+            for (IndexType j = 0; j < s->GetLength(); ++j) {
+                result->EmplaceBack(s->At(j));
+            }
+        }
+        for (IndexType j = i + N; j < length; ++j) {
+            result->EmplaceBack(Cell(j));
+        }
+        return result;
+    }
+
+    template <typename Func>
+    Sequence<T>* FlatMap(Func func) const {
+        SegmentedArraySequence<T, Allocator>* result = CreateEmpty();
+        Visit([&](const T& item) {
+            Sequence<T>* subseq = func(item);
+            for (IndexType j = 0; j < subseq->GetLength(); ++j) {
+                result->EmplaceBack(subseq->At(j));
+            }
+            delete subseq;
+        });
+        return result;
+    }
+
+    template <typename Predicate>
+    Option<T> Find(Predicate predicate) const {
+        for (IndexType i = 0; i < size; ++i) {
+            if (predicate(Cell(i))) {
+                return Option<T>::Some(Cell(i));
+            }
+        }
+        return Option<T>::None();
+    }
+
+    template <typename Predicate>
+    std::pair<Sequence<T>*, Sequence<T>*> Split(Predicate predicate) const {
+        SegmentedArraySequence<T, Allocator>* matching = CreateEmpty();
+        SegmentedArraySequence<T, Allocator>* notMatching = CreateEmpty();
+        Visit([&](const T& item) {
+            if (predicate(item)) {
+                matching->EmplaceBack(item);
+            } else {
+                notMatching->EmplaceBack(item);
+            }
+        });
+        return std::make_pair(matching, notMatching);
+    }
+
+    Sequence<T>* Concat(const Sequence<T>* other) const override {
+        SegmentedArraySequence<T, Allocator>* result = CreateEmpty();
+        Visit([&](const T& item) { result->EmplaceBack(item); });
+        for (IndexType i = 0; i < other->GetLength(); ++i) {
+            result->EmplaceBack(other->At(i));
+        }
+        return result;
+    }
+
+    IEnumerator<T>* GetEnumerator() const override {
+        return new SegmentedArrayEnumerator(*this);
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <utility>
 #include "Option.hpp"
+#include "Index.hpp"
 #include "IEnumerable.hpp"
 
 template<typename T>
@@ -8,20 +9,44 @@ class Sequence : public IEnumerable<T> {
 public:
     virtual ~Sequence() = default;
     
-    virtual T Get(int index) const = 0;
+    virtual T Get(IndexType index) const = 0;
     virtual T GetFirst() const = 0;
     virtual T GetLast() const = 0;
+
+    // Доступ к элементам по ссылке, без копирования
+    virtual const T& At(IndexType index) const = 0;
+    virtual const T& FirstRef() const = 0;
+    virtual const T& LastRef() const = 0;
     
-    virtual Option<T> TryGet(int index) const = 0;
+    virtual Option<T> TryGet(IndexType index) const = 0;
     virtual Option<T> TryGetFirst() const = 0;
     virtual Option<T> TryGetLast() const = 0;
     
-    virtual int GetLength() const = 0;
-    virtual Sequence<T>* GetSubsequence(int startIndex, int endIndex) const = 0;
+    virtual IndexType GetLength() const = 0;
+    virtual Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const = 0;
     
     virtual void Append(const T& item) = 0;
     virtual void Prepend(const T& item) = 0;
-    virtual void InsertAt(const T& item, int index) = 0;
+    virtual void InsertAt(const T& item, IndexType index) = 0;
+
+    virtual void Append(T&& item) = 0;
+    virtual void Prepend(T&& item) = 0;
+    virtual void InsertAt(T&& item, IndexType index) = 0;
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        Append(T(std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    void EmplaceFront(Args&&... args) {
+        Prepend(T(std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    void EmplaceAt(IndexType index, Args&&... args) {
+        InsertAt(T(std::forward<Args>(args)...), index);
+    }
     
     virtual Sequence<T>* Map(T (*func)(const T&)) const = 0;
     virtual Sequence<T>* Where(bool (*predicate)(const T&)) const = 0;
@@ -30,5 +55,5 @@ public:
     virtual Option<T> Find(bool (*predicate)(const T&)) const = 0;
     virtual std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const = 0;
     virtual Sequence<T>* Concat(const Sequence<T>* other) const = 0;
-    virtual Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const = 0;
+    virtual Sequence<T>* Slice(IndexType i, IndexType N, const Sequence<T>* s = nullptr) const = 0;
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "Sequence.hpp"
+
+// Тип элементов результата Map: явно указанный R, иначе - то, что возвращает func
+template <typename R, typename Func, typename T>
+using MapResult = std::conditional_t<std::is_void<R>::value,
+    std::decay_t<std::invoke_result_t<Func&, const T&>>, R>;
+
+template <typename Allocator, typename R>
+using ReboundAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<R>;
+
+// CRTP-слой между Sequence и конкретной последовательностью. Виртуальные HOF
+// с указателями на функции остаются для кода, работающего через Sequence<T>*,
+// и перенаправляются в шаблонные перегрузки Derived. Шаблонные версии
+// принимают любой вызываемый объект, в том числе лямбды с захватом, и при
+// вызове на конкретном типе встраиваются в цикл без косвенного вызова
+template <typename T, typename Derived>
+class SequenceOps : public Sequence<T> {
+private:
+    const Derived& Self() const {
+        return static_cast<const Derived&>(*this);
+    }
+
+public:
+    Sequence<T>* Map(T (*func)(const T&)) const override {
+        return Self().template Map<T>(func);
+    }
+
+    Sequence<T>* Where(bool (*predicate)(const T&)) const override {
+        return Self().template Where<bool (*)(const T&)>(predicate);
+    }
+
+    T Reduce(T (*func)(const T&, const T&), const T& initial) const override {
+        return Self().template Reduce<T (*)(const T&, const T&)>(func, initial);
+    }
+
+    Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
+        return Self().template FlatMap<Sequence<T>* (*)(const T&)>(func);
+    }
+
+    Option<T> Find(bool (*predicate)(const T&)) const override {
+        return Self().template Find<bool (*)(const T&)>(predicate);
+    }
+
+    std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
+        return Self().template Split<bool (*)(const T&)>(predicate);
+    }
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cmath>
+#include <utility>
+#include "BoundsCheck.hpp"
 #include "Complex.hpp"
 #include "DynamicArray.hpp"
 #include "Exceptions.hpp"
@@ -9,57 +11,69 @@
 template<typename T>
 class SquareMatrix {
 private:
-    int size;
+    IndexType size;
     DynamicArray<DynamicArray<T>> elements;
 
+    SquareMatrix(IndexType n, DynamicArray<DynamicArray<T>>&& rows) : size(n), elements(std::move(rows)) {}
+
+    // Доступ без проверки индексов для внутренних циклов
+    T& Cell(IndexType i, IndexType j) {
+        return elements.Data()[i].Data()[j];
+    }
+
+    const T& Cell(IndexType i, IndexType j) const {
+        return elements.Data()[i].Data()[j];
+    }
+
 public:
-    explicit SquareMatrix(int n) : size(n), elements(n) {
-        for (int i = 0; i < n; ++i) {
-            DynamicArray<T> row(n);
-            for (int j = 0; j < n; ++j) {
-                row.Set(j, T());
-            }
-            elements.Set(i, row);
+    explicit SquareMatrix(IndexType n) : size(n) {
+        elements.Reserve(n);
+        for (IndexType i = 0; i < n; ++i) {
+            elements.EmplaceBack(n);
         }
     }
-    SquareMatrix(const SquareMatrix<T>& other) : size(other.size), elements(other.size) {
-        for (int i = 0; i < size; ++i) {
-            DynamicArray<T> row(other.size);
-            for (int j = 0; j < size; ++j) {
-                row.Set(j, other.Get(i, j));
-            }
-            elements.Set(i, row);
+    SquareMatrix(IndexType n, const T& value) : size(n) {
+        elements.Reserve(n);
+        for (IndexType i = 0; i < n; ++i) {
+            elements.EmplaceBack(n, value);
         }
     }
+    SquareMatrix(const SquareMatrix<T>& other) : size(other.size), elements(other.elements) {}
+    SquareMatrix(SquareMatrix<T>&& other) noexcept : size(other.size), elements(std::move(other.elements)) {
+        other.size = 0;
+    }
 
     SquareMatrix<T>& operator=(const SquareMatrix<T>& other) {
         if (this != &other) {
             size = other.size;
-            elements = DynamicArray<DynamicArray<T>>(size);
-            for (int i = 0; i < size; ++i) {
-                DynamicArray<T> row(other.elements.Get(i));
-                elements.Set(i, row);
-            }
+            elements = other.elements;
+        }
+        return *this;
+    }
+
+    SquareMatrix<T>& operator=(SquareMatrix<T>&& other) noexcept {
+        if (this != &other) {
+            size = other.size;
+            elements = std::move(other.elements);
+            other.size = 0;
         }
         return *this;
     }
 
-    int GetSize() const { return size; }
+    IndexType GetSize() const { return size; }
 
-    T Get(int i, int j) const {
-        if (i < 0 || i >= size || j < 0 || j >= size) {
+    T Get(IndexType i, IndexType j) const {
+        if (BoundsCheckEnabled && (i < 0 || i >= size || j < 0 || j >= size)) {
             throw IndexOutOfRangeException("Index out of range");
         }
-        return elements.Get(i).Get(j);
+        return Cell(i, j);
     }
 
-    void Set(int i, int j, const T& value) {
-        if (i < 0 || i >= size || j < 0 || j >= size) {
+    void Set(IndexType i, IndexType j, const T& value) {
+        if (BoundsCheckEnabled && (i < 0 || i >= size || j < 0 || j >= size)) {
             throw IndexOutOfRangeException("Index out of range");
         }
-        DynamicArray<T> row = elements.Get(i);
-        row.Set(j, value);
-        elements.Set(i, row);
+        Cell(i, j) = value;
     }
 
     SquareMatrix<T> operator+(const SquareMatrix<T>& other) const {
@@ -67,90 +81,90 @@ public:
             throw InvalidArgumentException("Matrices must have the same size for addition");
         }
 
-        SquareMatrix<T> result(size);
-        for (int i = 0; i < size; ++i) {
-            for (int j = 0; j < size; ++j) {
-                result.Set(i, j, Get(i, j) + other.Get(i, j));
+        DynamicArray<DynamicArray<T>> rows;
+        rows.Reserve(size);
+        for (IndexType i = 0; i < size; ++i) {
+            DynamicArray<T>& row = rows.EmplaceBack();
+            row.Reserve(size);
+            for (IndexType j = 0; j < size; ++j) {
+                row.EmplaceBack(Cell(i, j) + other.Cell(i, j));
             }
         }
-        return result;
+        return SquareMatrix<T>(size, std::move(rows));
     }
 
     SquareMatrix<T> operator*(const T& scalar) const {
-        SquareMatrix<T> result(size);
-        for (int i = 0; i < size; ++i) {
-            for (int j = 0; j < size; ++j) {
-                result.Set(i, j, Get(i, j) * scalar);
+        DynamicArray<DynamicArray<T>> rows;
+        rows.Reserve(size);
+        for (IndexType i = 0; i < size; ++i) {
+            DynamicArray<T>& row = rows.EmplaceBack();
+            row.Reserve(size);
+            for (IndexType j = 0; j < size; ++j) {
+                row.EmplaceBack(Cell(i, j) * scalar);
             }
         }
-        return result;
+        return SquareMatrix<T>(size, std::move(rows));
     }
 
     double Norm() const {
         T sum = T();
-        for (int i = 0; i < size; ++i) {
-            for (int j = 0; j < size; ++j) {
-                sum = sum + Get(i, j) * Get(i, j);
+        for (IndexType i = 0; i < size; ++i) {
+            for (IndexType j = 0; j < size; ++j) {
+                sum = sum + Cell(i, j) * Cell(i, j);
             }
         }
         return std::sqrt(std::abs(sum));
     }
 
-    void MultiplyRow(int row, const T& scalar) {
+    void MultiplyRow(IndexType row, const T& scalar) {
         if (row < 0 || row >= size) {
             throw IndexOutOfRangeException("Invalid row index");
         }
-        for (int j = 0; j < size; ++j) {
-            Set(row, j, Get(row, j) * scalar);
+        for (IndexType j = 0; j < size; ++j) {
+            Cell(row, j) = Cell(row, j) * scalar;
         }
     }
 
-    void MultiplyColumn(int col, const T& scalar) {
+    void MultiplyColumn(IndexType col, const T& scalar) {
         if (col < 0 || col >= size) {
             throw IndexOutOfRangeException("Invalid column index");
         }
-        for (int i = 0; i < size; ++i) {
-            Set(i, col, Get(i, col) * scalar);
+        for (IndexType i = 0; i < size; ++i) {
+            Cell(i, col) = Cell(i, col) * scalar;
         }
     }
 
-    void AddRowMultiple(int destRow, int srcRow, const T& scalar) {
+    void AddRowMultiple(IndexType destRow, IndexType srcRow, const T& scalar) {
         if (destRow < 0 || destRow >= size || srcRow < 0 || srcRow >= size) {
             throw IndexOutOfRangeException("Invalid row index");
         }
-        for (int j = 0; j < size; ++j) {
-            Set(destRow, j, Get(destRow, j) + Get(srcRow, j) * scalar);
+        for (IndexType j = 0; j < size; ++j) {
+            Cell(destRow, j) = Cell(destRow, j) + Cell(srcRow, j) * scalar;
         }
     }
 
-    void AddColumnMultiple(int destCol, int srcCol, const T& scalar) {
+    void AddColumnMultiple(IndexType destCol, IndexType srcCol, const T& scalar) {
         if (destCol < 0 || destCol >= size || srcCol < 0 || srcCol >= size) {
             throw IndexOutOfRangeException("Invalid column index");
         }
-        for (int i = 0; i < size; ++i) {
-            Set(i, destCol, Get(i, destCol) + Get(i, srcCol) * scalar);
+        for (IndexType i = 0; i < size; ++i) {
+            Cell(i, destCol) = Cell(i, destCol) + Cell(i, srcCol) * scalar;
         }
     }
 
-    void SwapRows(int row1, int row2) {
+    void SwapRows(IndexType row1, IndexType row2) {
         if (row1 < 0 || row1 >= size || row2 < 0 || row2 >= size) {
             throw IndexOutOfRangeException("Invalid row index");
         }
-        for (int j = 0; j < size; ++j) {
-            T temp = Get(row1, j);
-            Set(row1, j, Get(row2, j));
-            Set(row2, j, temp);
-        }
+        std::swap(elements.Data()[row1], elements.Data()[row2]);
     }
 
-    void SwapColumns(int col1, int col2) {
+    void SwapColumns(IndexType col1, IndexType col2) {
         if (col1 < 0 || col1 >= size || col2 < 0 || col2 >= size) {
             throw IndexOutOfRangeException("Invalid column index");
         }
-        for (int i = 0; i < size; ++i) {
-            T temp = Get(i, col1);
-            Set(i, col1, Get(i, col2));
-            Set(i, col2, temp);
+        for (IndexType i = 0; i < size; ++i) {
+            std::swap(Cell(i, col1), Cell(i, col2));
         }
     }
 };
\ No newline at end of file
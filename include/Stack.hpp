@@ -1,32 +1,31 @@
 #pragma once
 
+#include <memory>
+#include <utility>
 #include "ArraySequence.hpp"
 #include "Exceptions.hpp"
 #include "IEnumerable.hpp"
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>, int InlineCapacity = 0>
 class Stack : public IEnumerable<T> {
 private:
-    ArraySequence<T> items;
+    ArraySequence<T, Allocator, InlineCapacity> items;
 
     class StackEnumerator : public IEnumerator<T> {
     private:
-        const ArraySequence<T>& sequence;
-        int currentIndex;
-        T currentValue;
+        const ArraySequence<T, Allocator, InlineCapacity>& sequence;
+        IndexType currentIndex;
 
     public:
-        explicit StackEnumerator(const ArraySequence<T>& seq)
+        explicit StackEnumerator(const ArraySequence<T, Allocator, InlineCapacity>& seq)
             : sequence(seq)
             , currentIndex(-1)
-            , currentValue()
         {}
         bool MoveNext() override
         {
             if (currentIndex + 1 < sequence.GetLength())
             {
                 currentIndex++;
-                currentValue = sequence.Get(currentIndex);
                 return true;
             }
             return false;
@@ -38,7 +37,7 @@ private:
             {
                 throw InvalidStateException("Enumerator is not in a valid position");
             }
-            return currentValue;
+            return sequence.At(currentIndex);
         }
 
         void Reset() override
@@ -49,27 +48,31 @@ private:
 
 public:
     Stack() = default;
+    explicit Stack(const Allocator& allocator) : items(allocator) {}
 
     void Push(const T& item)
     {
         items.Append(item);
     }
 
+    void Push(T&& item)
+    {
+        items.Append(std::move(item));
+    }
+
+    template<typename... Args>
+    void Emplace(Args&&... args)
+    {
+        items.EmplaceBack(std::forward<Args>(args)...);
+    }
+
     Option<T> Pop()
     {
         if (items.GetLength() == 0)
         {
             return Option<T>::None();
         }
-        T value = items.GetLast();
-        auto* newItems = new ArraySequence<T>();
-        for (int i = 0; i < items.GetLength() - 1; i++)
-        {
-            newItems->Append(items.Get(i));
-        }
-        items = *newItems;
-        delete newItems;
-        return Option<T>::Some(value);
+        return Option<T>::Some(items.RemoveLast());
     }
 
     Option<T> Top() const {
@@ -81,42 +84,44 @@ public:
         return items.GetLength() == 0;
     }
 
-    int GetLength() const
+    IndexType GetLength() const
     {
         return items.GetLength();
     }
 
-    int GetSize() const {
+    IndexType GetSize() const {
         return GetLength();
     }
 
-    T Get(int index) const
+    Allocator GetAllocator() const
+    {
+        return items.GetAllocator();
+    }
+
+    T Get(IndexType index) const
     {
         return items.Get(index);
     }
 
     Sequence<T>* GetSequence() const
     {
-        return new ArraySequence<T>(items);
+        return new ArraySequence<T, Allocator, InlineCapacity>(items);
     }
 
-    template<typename R>
-    Sequence<R>* Map(R (*func)(const T&)) const
+    // Map может менять тип элементов: Map<R>(func) или тип, выведенный из func
+    template<typename R = void, typename Func>
+    Sequence<MapResult<R, Func, T>>* Map(Func func) const
     {
-        auto* result = new ArraySequence<R>();
-        for (int i = 0; i < items.GetLength(); ++i)
-        {
-            result->Append(func(items.Get(i)));
-        }
-        return result;
+        return items.template Map<R>(func);
     }
 
-    Sequence<T>* Where(bool (*predicate)(const T&)) const
+    template<typename Predicate>
+    Sequence<T>* Where(Predicate predicate) const
     {
-        auto* result = new ArraySequence<T>();
-        for (int i = 0; i < items.GetLength(); ++i)
+        auto* result = new ArraySequence<T, Allocator, InlineCapacity>(items.GetAllocator());
+        for (IndexType i = 0; i < items.GetLength(); ++i)
         {
-            T current = items.Get(i);
+            const T& current = items.At(i);
             if (predicate(current))
             {
                 result->Append(current);
@@ -125,41 +130,47 @@ public:
         return result;
     }
 
-    T Reduce(T (*func)(const T&, const T&), const T& initial) const
+    template<typename Func>
+    T Reduce(Func func, const T& initial) const
     {
         T result = initial;
-        for (int i = 0; i < items.GetLength(); ++i)
+        for (IndexType i = 0; i < items.GetLength(); ++i)
         {
-            result = func(result, items.Get(i));
+            result = func(result, items.At(i));
         }
         return result;
     }
 
-    Stack<T>* Concat(const Stack<T>* other) const
+    Stack<T, Allocator, InlineCapacity>* Concat(const Stack<T, Allocator, InlineCapacity>* other) const
     {
-        auto* result = new Stack<T>();
-        for (int i = 0; i < items.GetLength(); ++i)
+        auto* result = new Stack<T, Allocator, InlineCapacity>(items.GetAllocator());
+        result->items.Reserve(items.GetLength() + other->GetLength());
+        for (IndexType i = 0; i < items.GetLength(); ++i)
         {
-            result->Push(items.Get(i));
+            result->Push(items.At(i));
         }
-        for (int i = 0; i < other->GetLength(); ++i)
+        for (IndexType i = 0; i < other->GetLength(); ++i)
         {
             result->Push(other->Get(i));
         }
         return result;
     }
 
-    Sequence<T>* GetSubsequence(int startIndex, int endIndex) const
+    Sequence<T>* GetSubsequence(IndexType startIndex, IndexType endIndex) const
     {
-        auto* result = new ArraySequence<T>();
-        for (int i = startIndex; i <= endIndex; i++)
+        auto* result = new ArraySequence<T, Allocator, InlineCapacity>(items.GetAllocator());
+        if (endIndex >= startIndex)
+        {
+            result->Reserve(endIndex - startIndex + 1);
+        }
+        for (IndexType i = startIndex; i <= endIndex; i++)
         {
-            result->Append(items.Get(i));
+            result->Append(items.At(i));
         }
         return result;
     }
 
-    bool ContainsSubsequence(const Stack<T>* subseq) const
+    bool ContainsSubsequence(const Stack<T, Allocator, InlineCapacity>* subseq) const
     {
         if (subseq->GetLength() == 0)
         {
@@ -170,12 +181,12 @@ public:
             return false;
         }
 
-        for (int i = 0; i <= items.GetLength() - subseq->GetLength(); ++i)
+        for (IndexType i = 0; i <= items.GetLength() - subseq->GetLength(); ++i)
         {
             bool match = true;
-            for (int j = 0; j < subseq->GetLength(); ++j)
+            for (IndexType j = 0; j < subseq->GetLength(); ++j)
             {
-                if (!(items.Get(i + j) == subseq->Get(j)))
+                if (!(items.At(i + j) == subseq->items.At(j)))
                 {
                     match = false;
                     break;
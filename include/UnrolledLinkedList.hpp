@@ -0,0 +1,570 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "Exceptions.hpp"
+#include "Index.hpp"
+#include "NodeSlab.hpp"
+
+// Узел развёрнутого списка: до Capacity элементов подряд,
+// занятые ячейки - [begin, end)
+template <typename T, int Capacity>
+struct UnrolledNode {
+    UnrolledNode* next;
+    UnrolledNode* prev;
+    int begin;
+    int end;
+    alignas(T) unsigned char storage[sizeof(T) * Capacity];
+
+    UnrolledNode() : next(nullptr), prev(nullptr), begin(0), end(0) {}
+
+    T* Slot(int index) {
+        return reinterpret_cast<T*>(storage) + index;
+    }
+
+    const T* Slot(int index) const {
+        return reinterpret_cast<const T*>(storage) + index;
+    }
+
+    int Count() const {
+        return end - begin;
+    }
+};
+
+// Развёрнутый связный список с тем же интерфейсом, что у LinkedList:
+// элементы лежат блоками в узлах примерно по 256 байт, поэтому обход
+// идёт по непрерывной памяти, а служебные данные делятся на весь узел.
+// Переполненный узел делится пополам, полупустой при удалении из
+// середины сливается с соседом
+template <typename T, typename Allocator = std::allocator<T>>
+class UnrolledLinkedList {
+public:
+    static constexpr int NodeCapacity = sizeof(T) * 4 >= 256 ? 4 : static_cast<int>(256 / sizeof(T));
+
+private:
+    using NodeType = UnrolledNode<T, NodeCapacity>;
+    using ElementAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using ElementTraits = std::allocator_traits<ElementAllocator>;
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<NodeType>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    NodeSlab<NodeType, NodeAllocator> nodes;
+    NodeType* head;
+    NodeType* tail;
+    IndexType size;
+
+    template <typename... Args>
+    void Construct(T* place, Args&&... args) {
+        ElementAllocator allocator(nodes.GetAllocator());
+        ElementTraits::construct(allocator, place, std::forward<Args>(args)...);
+    }
+
+    void DestroyElement(T* place) {
+        ElementAllocator allocator(nodes.GetAllocator());
+        ElementTraits::destroy(allocator, place);
+    }
+
+    // Новый пустой узел после after; nullptr - в начало списка
+    NodeType* LinkNode(NodeType* after) {
+        NodeType* node = nodes.Create();
+        node->prev = after;
+        node->next = after ? after->next : head;
+        if (node->next) {
+            node->next->prev = node;
+        } else {
+            tail = node;
+        }
+        if (after) {
+            after->next = node;
+        } else {
+            head = node;
+        }
+        return node;
+    }
+
+    void UnlinkNode(NodeType* node) {
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            head = node->next;
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        } else {
+            tail = node->prev;
+        }
+        nodes.Destroy(node);
+    }
+
+    // Переносит элементы узла в начало его ячеек
+    void Compact(NodeType* node) {
+        if (node->begin == 0) {
+            return;
+        }
+        int count = node->Count();
+        for (int i = 0; i < count; ++i) {
+            Construct(node->Slot(i), std::move(*node->Slot(node->begin + i)));
+            DestroyElement(node->Slot(node->begin + i));
+        }
+        node->begin = 0;
+        node->end = count;
+    }
+
+    // Делит полный узел пополам; верхняя половина уходит в новый узел
+    NodeType* Split(NodeType* node) {
+        NodeType* upper = LinkNode(node);
+        int middle = node->begin + node->Count() / 2;
+        for (int i = middle; i < node->end; ++i) {
+            Construct(upper->Slot(upper->end++), std::move(*node->Slot(i)));
+            DestroyElement(node->Slot(i));
+        }
+        node->end = middle;
+        return upper;
+    }
+
+    // Сливает next в node, если оба вместе помещаются в один узел
+    void MergeWithNext(NodeType* node) {
+        NodeType* next = node->next;
+        if (!next || node->Count() + next->Count() > NodeCapacity) {
+            return;
+        }
+        Compact(node);
+        for (int i = next->begin; i < next->end; ++i) {
+            Construct(node->Slot(node->end++), std::move(*next->Slot(i)));
+            DestroyElement(next->Slot(i));
+        }
+        UnlinkNode(next);
+    }
+
+    // Вставка в ячейку position узла (begin <= position <= end)
+    template <typename... Args>
+    std::pair<NodeType*, int> InsertIntoNode(NodeType* node, int position, Args&&... args) {
+        if (node->Count() == NodeCapacity) {
+            NodeType* upper = Split(node);
+            if (position > node->end) {
+                position -= node->end;
+                node = upper;
+            }
+        }
+        if (position == node->end && node->end < NodeCapacity) {
+            Construct(node->Slot(position), std::forward<Args>(args)...);
+            ++node->end;
+        } else if (position == node->begin && node->begin > 0) {
+            --position;
+            Construct(node->Slot(position), std::forward<Args>(args)...);
+            --node->begin;
+        } else if (node->end < NodeCapacity) {
+            T value(std::forward<Args>(args)...);
+            Construct(node->Slot(node->end), std::move(*node->Slot(node->end - 1)));
+            std::move_backward(node->Slot(position), node->Slot(node->end - 1), node->Slot(node->end));
+            ++node->end;
+            *node->Slot(position) = std::move(value);
+        } else {
+            T value(std::forward<Args>(args)...);
+            Construct(node->Slot(node->begin - 1), std::move(*node->Slot(node->begin)));
+            std::move(node->Slot(node->begin + 1), node->Slot(position), node->Slot(node->begin));
+            --node->begin;
+            --position;
+            *node->Slot(position) = std::move(value);
+        }
+        ++size;
+        return std::make_pair(node, position);
+    }
+
+    // Узел и ячейка элемента с заданным индексом; обход с ближайшего конца
+    std::pair<NodeType*, int> Locate(IndexType index) const {
+        if (index < size / 2) {
+            NodeType* node = head;
+            while (index >= node->Count()) {
+                index -= node->Count();
+                node = node->next;
+            }
+            return std::make_pair(node, node->begin + static_cast<int>(index));
+        }
+        IndexType fromEnd = size - 1 - index;
+        NodeType* node = tail;
+        while (fromEnd >= node->Count()) {
+            fromEnd -= node->Count();
+            node = node->prev;
+        }
+        return std::make_pair(node, node->end - 1 - static_cast<int>(fromEnd));
+    }
+
+    void Steal(UnrolledLinkedList& other) noexcept {
+        head = other.head;
+        tail = other.tail;
+        size = other.size;
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.size = 0;
+    }
+
+public:
+    class Cursor {
+    private:
+        friend class UnrolledLinkedList;
+        NodeType* node;
+        int slot;
+
+        Cursor(NodeType* node, int slot) : node(node), slot(slot) {}
+
+    public:
+        Cursor() : node(nullptr), slot(0) {}
+
+        bool IsValid() const {
+            return node != nullptr;
+        }
+
+        const T& Get() const {
+            if (!node) {
+                throw InvalidStateException("Cursor is not in a valid position");
+            }
+            return *node->Slot(slot);
+        }
+
+        void MoveNext() {
+            if (node && ++slot == node->end) {
+                node = node->next;
+                slot = node ? node->begin : 0;
+            }
+        }
+
+        void MovePrev() {
+            if (node && slot-- == node->begin) {
+                node = node->prev;
+                slot = node ? node->end - 1 : 0;
+            }
+        }
+    };
+
+    UnrolledLinkedList() : nodes(), head(nullptr), tail(nullptr), size(0) {}
+    explicit UnrolledLinkedList(const Allocator& allocator)
+        : nodes(NodeAllocator(allocator)), head(nullptr), tail(nullptr), size(0) {}
+    UnrolledLinkedList(const T* items, IndexType count, const Allocator& allocator = Allocator())
+        : nodes(NodeAllocator(allocator)), head(nullptr), tail(nullptr), size(0) {
+        if (count < 0) {
+            throw InvalidSizeException("Count cannot be negative");
+        }
+        for (IndexType i = 0; i < count; i++) {
+            Append(items[i]);
+        }
+    }
+
+    UnrolledLinkedList(const UnrolledLinkedList& other)
+        : nodes(NodeTraits::select_on_container_copy_construction(other.nodes.GetAllocator())),
+          head(nullptr), tail(nullptr), size(0) {
+        for (Cursor current = other.First(); current.IsValid(); current.MoveNext()) {
+            Append(current.Get());
+        }
+    }
+
+    UnrolledLinkedList(UnrolledLinkedList&& other) noexcept
+        : nodes(std::move(other.nodes)), head(nullptr), tail(nullptr), size(0) {
+        Steal(other);
+    }
+
+    UnrolledLinkedList& operator=(const UnrolledLinkedList& other) {
+        if (this != &other) {
+            Clear();
+            for (Cursor current = other.First(); current.IsValid(); current.MoveNext()) {
+                Append(current.Get());
+            }
+        }
+        return *this;
+    }
+
+    UnrolledLinkedList& operator=(UnrolledLinkedList&& other)
+        noexcept(NodeTraits::propagate_on_container_move_assignment::value) {
+        if (this == &other) {
+            return *this;
+        }
+        Clear();
+        if (NodeTraits::propagate_on_container_move_assignment::value
+            || nodes.GetAllocator() == other.nodes.GetAllocator()) {
+            nodes = std::move(other.nodes);
+            Steal(other);
+        } else {
+            for (NodeType* node = other.head; node; node = node->next) {
+                for (int i = node->begin; i < node->end; ++i) {
+                    Append(std::move(*node->Slot(i)));
+                }
+            }
+            other.Clear();
+        }
+        return *this;
+    }
+
+    Allocator GetAllocator() const {
+        return Allocator(nodes.GetAllocator());
+    }
+
+    ~UnrolledLinkedList() {
+        Clear();
+    }
+
+    T Get(IndexType index) const {
+        return At(index);
+    }
+
+    T GetFirst() const {
+        return FirstRef();
+    }
+
+    T GetLast() const {
+        return LastRef();
+    }
+
+    const T& At(IndexType index) const {
+        if (index < 0 || index >= size) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        std::pair<NodeType*, int> place = Locate(index);
+        return *place.first->Slot(place.second);
+    }
+
+    const T& FirstRef() const {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        return *head->Slot(head->begin);
+    }
+
+    const T& LastRef() const {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        return *tail->Slot(tail->end - 1);
+    }
+
+    IndexType GetSize() const {
+        return size;
+    }
+
+    void Append(const T& item) {
+        EmplaceBack(item);
+    }
+
+    void Append(T&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        NodeType* node = tail;
+        bool fresh = !node || node->end == NodeCapacity;
+        if (fresh) {
+            node = LinkNode(tail);
+        }
+        try {
+            Construct(node->Slot(node->end), std::forward<Args>(args)...);
+        } catch (...) {
+            if (fresh) {
+                UnlinkNode(node);
+            }
+            throw;
+        }
+        ++size;
+        return *node->Slot(node->end++);
+    }
+
+    void Prepend(const T& item) {
+        EmplaceFront(item);
+    }
+
+    void Prepend(T&& item) {
+        EmplaceFront(std::move(item));
+    }
+
+    // Новый головной узел заполняется с конца, чтобы следующие
+    // вставки в начало тоже обходились без сдвига
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        NodeType* node = head;
+        bool fresh = !node || node->begin == 0;
+        if (fresh) {
+            node = LinkNode(nullptr);
+            node->begin = NodeCapacity;
+            node->end = NodeCapacity;
+        }
+        try {
+            Construct(node->Slot(node->begin - 1), std::forward<Args>(args)...);
+        } catch (...) {
+            if (fresh) {
+                UnlinkNode(node);
+            }
+            throw;
+        }
+        ++size;
+        return *node->Slot(--node->begin);
+    }
+
+    void InsertAt(const T& item, IndexType index) {
+        EmplaceAt(index, item);
+    }
+
+    void InsertAt(T&& item, IndexType index) {
+        EmplaceAt(index, std::move(item));
+    }
+
+    template <typename... Args>
+    T& EmplaceAt(IndexType index, Args&&... args) {
+        if (index < 0 || index > size) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        if (index == 0) {
+            return EmplaceFront(std::forward<Args>(args)...);
+        }
+        if (index == size) {
+            return EmplaceBack(std::forward<Args>(args)...);
+        }
+        std::pair<NodeType*, int> place = Locate(index);
+        place = InsertIntoNode(place.first, place.second, std::forward<Args>(args)...);
+        return *place.first->Slot(place.second);
+    }
+
+    T RemoveFirst() {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        T value = std::move(*head->Slot(head->begin));
+        DestroyElement(head->Slot(head->begin++));
+        --size;
+        if (head->Count() == 0) {
+            UnlinkNode(head);
+        }
+        return value;
+    }
+
+    T RemoveLast() {
+        if (size == 0) {
+            throw EmptySequenceException();
+        }
+        T value = std::move(*tail->Slot(tail->end - 1));
+        DestroyElement(tail->Slot(--tail->end));
+        --size;
+        if (tail->Count() == 0) {
+            UnlinkNode(tail);
+        }
+        return value;
+    }
+
+    Cursor First() const {
+        return head ? Cursor(head, head->begin) : Cursor();
+    }
+
+    Cursor Last() const {
+        return tail ? Cursor(tail, tail->end - 1) : Cursor();
+    }
+
+    Cursor InsertAfter(Cursor position, const T& item) {
+        return EmplaceAfter(position, item);
+    }
+
+    Cursor InsertAfter(Cursor position, T&& item) {
+        return EmplaceAfter(position, std::move(item));
+    }
+
+    template <typename... Args>
+    Cursor EmplaceAfter(Cursor position, Args&&... args) {
+        if (!position.node) {
+            EmplaceFront(std::forward<Args>(args)...);
+            return First();
+        }
+        std::pair<NodeType*, int> place =
+            InsertIntoNode(position.node, position.slot + 1, std::forward<Args>(args)...);
+        return Cursor(place.first, place.second);
+    }
+
+    // Переносит узлы other после элемента position (недействительный курсор -
+    // в начало); узел под курсором при необходимости делится, other пустеет
+    void Splice(Cursor position, UnrolledLinkedList& other) {
+        if (this == &other || other.size == 0) {
+            return;
+        }
+        if (!(nodes.GetAllocator() == other.nodes.GetAllocator())) {
+            for (Cursor current = other.First(); current.IsValid(); current.MoveNext()) {
+                position = EmplaceAfter(position, std::move(*current.node->Slot(current.slot)));
+            }
+            other.Clear();
+            return;
+        }
+        NodeType* after = position.node;
+        if (after && position.slot + 1 < after->end) {
+            // хвост узла после курсора уходит в отдельный узел
+            NodeType* rest = LinkNode(after);
+            for (int i = position.slot + 1; i < after->end; ++i) {
+                Construct(rest->Slot(rest->end++), std::move(*after->Slot(i)));
+                DestroyElement(after->Slot(i));
+            }
+            after->end = position.slot + 1;
+        }
+        NodeType* before = after ? after->next : head;
+        other.head->prev = after;
+        other.tail->next = before;
+        if (after) {
+            after->next = other.head;
+        } else {
+            head = other.head;
+        }
+        if (before) {
+            before->prev = other.tail;
+        } else {
+            tail = other.tail;
+        }
+        size += other.size;
+        nodes.Adopt(other.nodes);
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.size = 0;
+    }
+
+    void AppendList(UnrolledLinkedList& other) {
+        Splice(Last(), other);
+    }
+
+    // Удаляет элемент под курсором и возвращает курсор на следующий
+    Cursor Erase(Cursor position) {
+        if (!position.node) {
+            throw InvalidStateException("Cursor is not in a valid position");
+        }
+        NodeType* node = position.node;
+        int slot = position.slot;
+        std::move(node->Slot(slot + 1), node->Slot(node->end), node->Slot(slot));
+        DestroyElement(node->Slot(--node->end));
+        --size;
+        if (node->Count() == 0) {
+            NodeType* next = node->next;
+            UnlinkNode(node);
+            return next ? Cursor(next, next->begin) : Cursor();
+        }
+        if (node->Count() < NodeCapacity / 2) {
+            slot -= node->begin;
+            MergeWithNext(node);
+            slot += node->begin;
+        }
+        if (slot == node->end) {
+            return node->next ? Cursor(node->next, node->next->begin) : Cursor();
+        }
+        return Cursor(node, slot);
+    }
+
+    // Выделяет узлы под count следующих добавлений в конец одним блоком
+    void Reserve(IndexType count) {
+        nodes.Reserve((count + NodeCapacity - 1) / NodeCapacity);
+    }
+
+    void Clear() {
+        if (!std::is_trivially_destructible<T>::value) {
+            for (NodeType* node = head; node; node = node->next) {
+                for (int i = node->begin; i < node->end; ++i) {
+                    DestroyElement(node->Slot(i));
+                }
+            }
+        }
+        head = nullptr;
+        tail = nullptr;
+        size = 0;
+        nodes.Release();
+    }
+};
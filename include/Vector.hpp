@@ -1,9 +1,12 @@
 #pragma once
 
 #include <cmath>
+#include <type_traits>
+#include <utility>
 #include "Complex.hpp"
 #include "DynamicArray.hpp"
 #include "Exceptions.hpp"
+#include "Parallel.hpp"
 
 template<typename T>
 class Vector {
@@ -12,25 +15,35 @@ private:
 
 public:
     Vector() = default;
+    explicit Vector(const DynamicArray<T>& elements) : elements(elements) {}
+    explicit Vector(DynamicArray<T>&& elements) : elements(std::move(elements)) {}
     
-    explicit Vector(int size) : elements(size) {
-        for (int i = 0; i < size; ++i) {
-            elements.Set(i, T());
-        }
-    }
+    explicit Vector(IndexType size) : elements(size) {}
+    Vector(IndexType size, const T& value) : elements(size, value) {}
     
-    Vector(const T* items, int count) : elements(items, count) {}
+    Vector(const T* items, IndexType count) : elements(items, count) {}
     Vector(const Vector<T>& other) : elements(other.elements) {}
+    Vector(Vector<T>&& other) noexcept : elements(std::move(other.elements)) {}
+
+    Vector<T>& operator=(const Vector<T>& other) {
+        elements = other.elements;
+        return *this;
+    }
 
-    int GetSize() const {
+    Vector<T>& operator=(Vector<T>&& other) noexcept {
+        elements = std::move(other.elements);
+        return *this;
+    }
+
+    IndexType GetSize() const {
         return elements.GetSize();
     }
 
-    T Get(int index) const {
+    T Get(IndexType index) const {
         return elements.Get(index);
     }
 
-    void Set(int index, const T& value) {
+    void Set(IndexType index, const T& value) {
         elements.Set(index, value);
     }
 
@@ -39,25 +52,31 @@ public:
             throw InvalidArgumentException("Vectors must have the same size for addition");
         }
 
-        Vector<T> result(GetSize());
-        for (int i = 0; i < GetSize(); ++i) {
-            result.Set(i, Get(i) + other.Get(i));
+        const T* lhs = elements.Data();
+        const T* rhs = other.elements.Data();
+        DynamicArray<T> result;
+        result.Reserve(GetSize());
+        for (IndexType i = 0; i < GetSize(); ++i) {
+            result.EmplaceBack(lhs[i] + rhs[i]);
         }
-        return result;
+        return Vector<T>(std::move(result));
     }
 
     Vector<T> operator*(const T& scalar) const {
-        Vector<T> result(GetSize());
-        for (int i = 0; i < GetSize(); ++i) {
-            result.Set(i, Get(i) * scalar);
+        const T* data = elements.Data();
+        DynamicArray<T> result;
+        result.Reserve(GetSize());
+        for (IndexType i = 0; i < GetSize(); ++i) {
+            result.EmplaceBack(data[i] * scalar);
         }
-        return result;
+        return Vector<T>(std::move(result));
     }
 
     double Norm() const {
+        const T* data = elements.Data();
         T sum = T();
-        for (int i = 0; i < GetSize(); ++i) {
-            sum = sum + Get(i) * Get(i);
+        for (IndexType i = 0; i < GetSize(); ++i) {
+            sum = sum + data[i] * data[i];
         }
         return std::sqrt(std::abs(sum));
     }
@@ -67,10 +86,39 @@ public:
             throw InvalidArgumentException("Vectors must have the same size for dot product");
         }
 
+        const T* lhs = elements.Data();
+        const T* rhs = other.elements.Data();
         T result = T();
-        for (int i = 0; i < GetSize(); ++i) {
-            result = result + Get(i) * other.Get(i);
+        for (IndexType i = 0; i < GetSize(); ++i) {
+            result = result + lhs[i] * rhs[i];
         }
         return result;
     }
+
+    // Параллельные HOF; chunkSize - число элементов на один захват потоком
+    template<typename Func>
+    auto ParallelMap(Func func, IndexType chunkSize = ParallelChunkSize) const {
+        using Result = std::decay_t<std::invoke_result_t<Func&, const T&>>;
+        DynamicArray<Result> result;
+        ParallelMapRange(elements.Data(), GetSize(), func, chunkSize, result);
+        return Vector<Result>(std::move(result));
+    }
+
+    template<typename Predicate>
+    Vector<T> ParallelWhere(Predicate predicate, IndexType chunkSize = ParallelChunkSize) const {
+        DynamicArray<T> result;
+        ParallelWhereRange(elements.Data(), GetSize(), predicate, chunkSize, result);
+        return Vector<T>(std::move(result));
+    }
+
+    template<typename Func>
+    T ParallelReduce(Func func, const T& initial, IndexType chunkSize = ParallelChunkSize) const {
+        return ParallelReduceRange(elements.Data(), GetSize(), func, initial, chunkSize);
+    }
+
+    template<typename Predicate>
+    Option<T> ParallelFind(Predicate predicate, IndexType chunkSize = ParallelChunkSize) const {
+        IndexType index = ParallelFindRange(elements.Data(), GetSize(), predicate, chunkSize);
+        return index < 0 ? Option<T>::None() : Option<T>::Some(elements.Data()[index]);
+    }
 };
\ No newline at end of file
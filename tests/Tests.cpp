@@ -11,9 +11,23 @@
 #include "SquareMatrix.hpp"
 #include "RectangularMatrix.hpp"
 #include "Deque.hpp"
+#include "DynamicArray.hpp"
+#include "ArraySequence.hpp"
+#include "Allocators.hpp"
+#include "LinkedList.hpp"
+#include "ListSequence.hpp"
+#include "ImmutableArraySequence.hpp"
+#include "ImmutableListSequence.hpp"
+#include "GapBufferSequence.hpp"
+#include "RopeSequence.hpp"
+#include "BTreeSequence.hpp"
+#include "SegmentedArraySequence.hpp"
+#include "Query.hpp"
 #include <string>
 #include <functional>
 #include <complex>
+#include <cstdlib>
+#include <atomic>
 
 // Вспомогательные функции для тестов
 bool isEven(const int& x) { return x % 2 == 0; }
@@ -86,6 +100,15 @@ TEST(StackTest, HigherOrderFunctions) {
     
     int result = stack.Reduce(sum, 0);
     EXPECT_EQ(result, 6);
+
+    Stack<int> inner;
+    inner.Push(2);
+    inner.Push(3);
+    EXPECT_TRUE(stack.ContainsSubsequence(&inner));
+    inner.Push(1);
+    EXPECT_FALSE(stack.ContainsSubsequence(&inner));
+    Stack<int> empty;
+    EXPECT_TRUE(stack.ContainsSubsequence(&empty));
 }
 
 TEST(StackTest, CustomClassOperations) {
@@ -525,6 +548,64 @@ TEST(PriorityQueueTest, ConcatOperation) {
     delete combined;
 }
 
+TEST(PriorityQueueTest, IterationAndDequeueOrder) {
+    PriorityQueue<int> pq;
+    const int values[] = {10, 20, 30, 40, 50, 60};
+    const int priorities[] = {1, 5, 3, 5, 0, 3};
+    for (int i = 0; i < 6; ++i) {
+        pq.Enqueue(values[i], priorities[i]);
+    }
+
+    // перечисление, GetSequence, Where и ContainsSubsequence - в порядке добавления
+    IEnumerator<int>* enumerator = pq.GetEnumerator();
+    for (int value : values) {
+        ASSERT_TRUE(enumerator->MoveNext());
+        EXPECT_EQ(enumerator->Current(), value);
+    }
+    EXPECT_FALSE(enumerator->MoveNext());
+    delete enumerator;
+    Sequence<int>* inserted = pq.GetSequence();
+    EXPECT_EQ(inserted->Get(1), 20);
+    EXPECT_EQ(inserted->GetLast(), 60);
+    delete inserted;
+    Sequence<int>* large = pq.Where([](const int& x) { return x > 25; });
+    EXPECT_EQ(large->GetFirst(), 30);
+    delete large;
+    ListSequence<int> adjacent;
+    adjacent.Append(30);
+    adjacent.Append(40);
+    EXPECT_TRUE(pq.ContainsSubsequence(&adjacent));
+
+    // Map и GetSubsequence - по убыванию приоритета, равные в порядке добавления
+    Sequence<int>* mapped = pq.Map([](const int& x) { return x + 1; });
+    const int byPriority[] = {21, 41, 31, 61, 11, 51};
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(mapped->Get(i), byPriority[i]);
+    }
+    delete mapped;
+    Sequence<int>* middle = pq.GetSubsequence(1, 3);
+    EXPECT_EQ(middle->GetFirst(), 40);
+    EXPECT_EQ(middle->GetLast(), 60);
+    delete middle;
+
+    // копия и перемещённая очередь отдают элементы в том же порядке
+    PriorityQueue<int> copy(pq);
+    PriorityQueue<int> moved;
+    moved.Enqueue(-1, 100);
+    moved = std::move(copy);
+    pq.Enqueue(70, 5);
+    const int expected[] = {20, 40, 70, 30, 60, 10, 50};
+    for (int value : expected) {
+        EXPECT_EQ(pq.Dequeue().getValue(), value);
+    }
+    for (int i = 0; i < 7; ++i) {
+        if (expected[i] != 70) {
+            EXPECT_EQ(moved.Dequeue().getValue(), expected[i]);
+        }
+    }
+    EXPECT_TRUE(moved.IsEmpty());
+}
+
 // Тесты для Vector
 TEST(VectorTest, BasicOperations) {
     // Тест для целых чисел
@@ -761,4 +842,1932 @@ TEST(DequeTest, MergeOperations) {
     EXPECT_EQ(mergedReverse->Get(4), 1);
     EXPECT_EQ(mergedReverse->Get(5), 2);
     delete mergedReverse;
-}
\ No newline at end of file
+}
+
+// Тесты для DynamicArray
+TEST(DynamicArrayTest, CapacityManagement) {
+    DynamicArray<int> array;
+    EXPECT_EQ(array.GetSize(), 0);
+    EXPECT_EQ(array.GetCapacity(), 0);
+
+    array.Reserve(10);
+    EXPECT_EQ(array.GetSize(), 0);
+    EXPECT_GE(array.GetCapacity(), 10);
+
+    for (int i = 0; i < 100; ++i) {
+        array.PushBack(i);
+    }
+    EXPECT_EQ(array.GetSize(), 100);
+    EXPECT_GE(array.GetCapacity(), 100);
+    EXPECT_EQ(array.Get(99), 99);
+
+    array.PopBack();
+    EXPECT_EQ(array.GetSize(), 99);
+    array.ShrinkToFit();
+    EXPECT_EQ(array.GetCapacity(), 99);
+    EXPECT_EQ(array.Get(98), 98);
+
+    array.Resize(120);
+    EXPECT_EQ(array.Get(110), 0);
+    array.Resize(5);
+    EXPECT_EQ(array.GetSize(), 5);
+    if (BoundsCheckEnabled) {
+        EXPECT_THROW(array.Get(5), IndexOutOfRangeException);
+    }
+    EXPECT_THROW(array.Reserve(-1), InvalidSizeException);
+}
+
+TEST(DynamicArrayTest, GeometricGrowth) {
+    DynamicArray<int> array;
+    int reallocations = 0;
+    int lastCapacity = array.GetCapacity();
+    for (int i = 0; i < 1000000; ++i) {
+        array.PushBack(i);
+        if (array.GetCapacity() != lastCapacity) {
+            ++reallocations;
+            lastCapacity = array.GetCapacity();
+        }
+    }
+    EXPECT_EQ(array.GetSize(), 1000000);
+    EXPECT_LT(reallocations, 40);
+
+    // Добавление ссылки на собственный элемент во время роста
+    DynamicArray<std::string> strings;
+    strings.PushBack("self");
+    for (int i = 0; i < 10; ++i) {
+        strings.PushBack(strings[0]);
+    }
+    EXPECT_EQ(strings.Get(10), "self");
+}
+
+TEST(ArraySequenceTest, AppendManyElements) {
+    ArraySequence<int> sequence;
+    for (int i = 0; i < 2000000; ++i) {
+        sequence.Append(i);
+    }
+    EXPECT_EQ(sequence.GetLength(), 2000000);
+    EXPECT_EQ(sequence.GetLast(), 1999999);
+
+    Stack<int> stack;
+    for (int i = 0; i < 2000000; ++i) {
+        stack.Push(i);
+    }
+    EXPECT_EQ(stack.Pop().getValue(), 1999999);
+    EXPECT_EQ(stack.GetSize(), 1999999);
+
+    Sequence<int>* mapped = sequence.Map(multiplyByTwo);
+    EXPECT_EQ(mapped->GetLength(), 2000000);
+    EXPECT_EQ(mapped->Get(10), 20);
+    delete mapped;
+}
+
+// Тип, считающий копирования, для тестов перемещения
+struct CopyCounter {
+    static int copies;
+    int value;
+
+    CopyCounter(int v = 0) : value(v) {}
+    CopyCounter(const CopyCounter& other) : value(other.value) { ++copies; }
+    CopyCounter(CopyCounter&& other) noexcept : value(other.value) {}
+    CopyCounter& operator=(const CopyCounter& other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    CopyCounter& operator=(CopyCounter&& other) noexcept {
+        value = other.value;
+        return *this;
+    }
+    bool operator==(const CopyCounter& other) const { return value == other.value; }
+};
+
+int CopyCounter::copies = 0;
+
+TEST(MoveSemanticsTest, ContainersDoNotCopyOnHotPath) {
+    CopyCounter::copies = 0;
+
+    DynamicArray<CopyCounter> array;
+    for (int i = 0; i < 1000; ++i) {
+        array.PushBack(CopyCounter(i));
+    }
+    array.EmplaceBack(1000);
+    DynamicArray<CopyCounter> movedArray(std::move(array));
+    EXPECT_EQ(movedArray.GetSize(), 1001);
+    EXPECT_EQ(array.GetSize(), 0);
+
+    ArraySequence<CopyCounter> arraySequence;
+    arraySequence.Append(CopyCounter(1));
+    arraySequence.Prepend(CopyCounter(0));
+    arraySequence.EmplaceAt(1, 5);
+    ArraySequence<CopyCounter> movedSequence = std::move(arraySequence);
+    EXPECT_EQ(movedSequence.GetLength(), 3);
+    EXPECT_EQ(arraySequence.GetLength(), 0);
+
+    ListSequence<CopyCounter> listSequence;
+    listSequence.Append(CopyCounter(1));
+    listSequence.EmplaceFront(0);
+    listSequence.InsertAt(CopyCounter(2), 2);
+    ListSequence<CopyCounter> movedList(std::move(listSequence));
+    EXPECT_EQ(movedList.GetLength(), 3);
+    EXPECT_EQ(listSequence.GetLength(), 0);
+
+    Stack<CopyCounter> stack;
+    stack.Push(CopyCounter(1));
+    stack.Emplace(2);
+    Stack<CopyCounter> movedStack = std::move(stack);
+    EXPECT_EQ(movedStack.GetSize(), 2);
+
+    EXPECT_EQ(CopyCounter::copies, 0);
+}
+
+TEST(MoveSemanticsTest, EmplaceThroughHierarchy) {
+    time_t now = time(nullptr);
+
+    Stack<Person> stack;
+    stack.Emplace(PersonID{1, 1}, "John", "", "Doe", now);
+    EXPECT_EQ(stack.Top().getValue().GetFullName(), "John Doe");
+
+    Queue<Person> queue;
+    queue.Emplace(PersonID{1, 2}, "Jane", "", "Smith", now);
+    EXPECT_EQ(queue.Dequeue().getValue().GetFullName(), "Jane Smith");
+
+    Deque<std::string> deque;
+    deque.EmplaceBack(3, 'b');
+    deque.EmplaceFront(2, 'a');
+    EXPECT_EQ(deque.Get(0), "aa");
+    EXPECT_EQ(deque.Get(1), "bbb");
+
+    PriorityQueue<std::string> pq;
+    pq.Emplace(1, "low");
+    pq.Emplace(5, 4, 'x');
+    EXPECT_EQ(pq.Dequeue().getValue(), "xxxx");
+
+    Sequence<std::string>* sequence = new ArraySequence<std::string>();
+    sequence->EmplaceBack(2, 'z');
+    sequence->EmplaceFront("first");
+    EXPECT_EQ(sequence->Get(0), "first");
+    EXPECT_EQ(sequence->Get(1), "zz");
+    delete sequence;
+}
+
+// Тип без конструктора по умолчанию, считающий живые объекты
+struct NoDefault {
+    // атомарный: параллельные HOF строят элементы из нескольких потоков
+    static std::atomic<int> alive;
+    int value;
+
+    explicit NoDefault(int v) : value(v) { ++alive; }
+    NoDefault(const NoDefault& other) : value(other.value) { ++alive; }
+    NoDefault(NoDefault&& other) noexcept : value(other.value) { ++alive; }
+    NoDefault& operator=(const NoDefault& other) = default;
+    NoDefault& operator=(NoDefault&& other) = default;
+    ~NoDefault() { --alive; }
+
+    NoDefault operator+(const NoDefault& other) const { return NoDefault(value + other.value); }
+    NoDefault operator*(const NoDefault& other) const { return NoDefault(value * other.value); }
+    bool operator==(const NoDefault& other) const { return value == other.value; }
+};
+
+std::atomic<int> NoDefault::alive(0);
+
+TEST(RawStorageTest, NonDefaultConstructibleElements) {
+    NoDefault::alive = 0;
+    {
+        DynamicArray<NoDefault> array;
+        array.Reserve(100);
+        EXPECT_EQ(NoDefault::alive, 0);
+        for (int i = 0; i < 50; ++i) {
+            array.EmplaceBack(i);
+        }
+        EXPECT_EQ(NoDefault::alive, 50);
+        array.Resize(10, NoDefault(7));
+        EXPECT_EQ(NoDefault::alive, 10);
+        array.Resize(12, NoDefault(7));
+        EXPECT_EQ(array.Get(11).value, 7);
+        DynamicArray<NoDefault> copy(array);
+        copy = array;
+        EXPECT_EQ(NoDefault::alive, 24);
+
+        ArraySequence<NoDefault> sequence;
+        sequence.EmplaceBack(1);
+        sequence.Prepend(NoDefault(0));
+        EXPECT_EQ(sequence.GetFirst().value, 0);
+        EXPECT_TRUE(sequence.TryGet(5).isNone());
+
+        Stack<NoDefault> stack;
+        stack.Emplace(1);
+        stack.Push(NoDefault(2));
+        EXPECT_EQ(stack.Pop().getValue().value, 2);
+        EXPECT_TRUE(stack.Top().isSome());
+        EXPECT_EQ(stack.Pop().getValue().value, 1);
+        EXPECT_TRUE(stack.Pop().isNone());
+    }
+    EXPECT_EQ(NoDefault::alive, 0);
+}
+
+TEST(RawStorageTest, VectorsAndMatricesWithoutDefaultConstructor) {
+    Vector<NoDefault> v1(3, NoDefault(2));
+    Vector<NoDefault> v2(3, NoDefault(5));
+    auto vsum = v1 + v2;
+    EXPECT_EQ(vsum.Get(2).value, 7);
+    auto vscaled = v1 * NoDefault(3);
+    EXPECT_EQ(vscaled.Get(0).value, 6);
+
+    SquareMatrix<NoDefault> square(2, NoDefault(1));
+    square.Set(0, 1, NoDefault(4));
+    auto squareSum = square + square;
+    EXPECT_EQ(squareSum.Get(0, 1).value, 8);
+    square.SwapRows(0, 1);
+    EXPECT_EQ(square.Get(1, 1).value, 4);
+
+    RectangularMatrix<NoDefault> rect(2, 3, NoDefault(1));
+    rect.Set(1, 2, NoDefault(9));
+    EXPECT_EQ(rect.GetColumn(2).Get(1).value, 9);
+    EXPECT_EQ(rect.GetRow(1).Get(2).value, 9);
+    rect.SwapColumns(0, 2);
+    EXPECT_EQ(rect.Get(1, 0).value, 9);
+}
+
+// Аллокатор, считающий выделения и освобождения
+struct AllocationStats {
+    int allocations = 0;
+    int deallocations = 0;
+};
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    AllocationStats* stats;
+
+    explicit CountingAllocator(AllocationStats* stats) : stats(stats) {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : stats(other.stats) {}
+
+    T* allocate(std::size_t count) {
+        ++stats->allocations;
+        return std::allocator<T>().allocate(count);
+    }
+    void deallocate(T* pointer, std::size_t count) {
+        ++stats->deallocations;
+        std::allocator<T>().deallocate(pointer, count);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const { return stats == other.stats; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>& other) const { return stats != other.stats; }
+};
+
+TEST(AllocatorTest, ContainersUseProvidedAllocator) {
+    AllocationStats stats;
+    {
+        CountingAllocator<int> allocator(&stats);
+
+        Stack<int, CountingAllocator<int>> stack(allocator);
+        Queue<int, CountingAllocator<int>> queue(allocator);
+        Deque<int, CountingAllocator<int>> deque(allocator);
+        PriorityQueue<int, CountingAllocator<int>> pq(allocator);
+        for (int i = 0; i < 10; ++i) {
+            stack.Push(i);
+            queue.Enqueue(i);
+            deque.PushFront(i);
+            pq.Enqueue(i, i);
+        }
+        EXPECT_EQ(stack.Pop().getValue(), 9);
+        EXPECT_EQ(queue.Dequeue().getValue(), 0);
+        EXPECT_EQ(deque.PopBack().getValue(), 0);
+        EXPECT_EQ(pq.Dequeue().getValue(), 9);
+
+        Sequence<int>* mapped = stack.Map(multiplyByTwo);
+        EXPECT_EQ(mapped->Get(1), 2);
+        delete mapped;
+
+        auto* copy = new ArraySequence<int, CountingAllocator<int>>(allocator);
+        copy->Append(1);
+        Sequence<int>* filtered = copy->Where(isEven);
+        EXPECT_EQ(filtered->GetLength(), 0);
+        delete filtered;
+        delete copy;
+
+        EXPECT_GT(stats.allocations, 0);
+    }
+    EXPECT_EQ(stats.allocations, stats.deallocations);
+}
+
+TEST(AllocatorTest, MonotonicArena) {
+    alignas(std::max_align_t) unsigned char buffer[1024];
+    MonotonicArena arena(buffer, sizeof(buffer), 4096);
+
+    void* first = arena.Allocate(10, 8);
+    void* second = arena.Allocate(16, 16);
+    EXPECT_EQ(reinterpret_cast<std::size_t>(second) % 16, 0u);
+    EXPECT_GE(static_cast<unsigned char*>(first), buffer);
+    EXPECT_LT(static_cast<unsigned char*>(second), buffer + sizeof(buffer));
+
+    {
+        ArenaAllocator<int> allocator(arena);
+        ListSequence<int, ArenaAllocator<int>> list(allocator);
+        ArraySequence<std::string, ArenaAllocator<std::string>> strings(
+            (ArenaAllocator<std::string>(allocator)));
+        for (int i = 0; i < 10000; ++i) {
+            list.Append(i);
+            strings.Append("value");
+        }
+        EXPECT_EQ(list.GetLast(), 9999);
+        EXPECT_EQ(strings.Get(9999), "value");
+
+        ListSequence<int, ArenaAllocator<int>> moved(allocator);
+        moved = std::move(list);
+        EXPECT_EQ(moved.GetLength(), 10000);
+    }
+    arena.Release();
+    EXPECT_EQ(arena.Allocate(8, 8), static_cast<void*>(buffer));
+}
+
+TEST(AllocatorTest, PoolAllocatorReusesChunks) {
+    PoolResource resource;
+    PoolAllocator<int> allocator(resource);
+
+    int* first = allocator.allocate(1);
+    allocator.deallocate(first, 1);
+    int* second = allocator.allocate(1);
+    EXPECT_EQ(first, second);
+    allocator.deallocate(second, 1);
+
+    int* large = allocator.allocate(1000);
+    large[999] = 1;
+    allocator.deallocate(large, 1000);
+
+    Queue<Person, PoolAllocator<Person>> queue((PoolAllocator<Person>(resource)));
+    time_t now = time(nullptr);
+    for (int i = 0; i < 1000; ++i) {
+        queue.Enqueue(Person(PersonID{1, i}, "John", "", "Doe", now));
+    }
+    EXPECT_EQ(queue.GetSize(), 1000);
+    EXPECT_EQ(queue.Dequeue().getValue().GetID().number, 0);
+}
+
+// Тесты для слаба узлов LinkedList
+TEST(NodeSlabTest, NodesAreCarvedFromBlocks) {
+    AllocationStats stats;
+    {
+        CountingAllocator<std::string> allocator(&stats);
+        LinkedList<std::string, CountingAllocator<std::string>> list(allocator);
+        for (int i = 0; i < 1000; ++i) {
+            list.Append(std::to_string(i));
+        }
+        EXPECT_LT(stats.allocations, 10);
+        EXPECT_EQ(list.GetLast(), "999");
+
+        list.Clear();
+        EXPECT_EQ(stats.allocations, stats.deallocations);
+        list.Prepend("again");
+        EXPECT_EQ(list.GetFirst(), "again");
+
+        AllocationStats otherStats;
+        CountingAllocator<std::string> otherAllocator(&otherStats);
+        LinkedList<std::string, CountingAllocator<std::string>> other(otherAllocator);
+        other = std::move(list);
+        EXPECT_EQ(other.GetFirst(), "again");
+        EXPECT_EQ(list.GetSize(), 0);
+        EXPECT_EQ(otherStats.allocations, 1);
+    }
+    EXPECT_EQ(stats.allocations, stats.deallocations);
+}
+
+// Тесты для встроенного буфера DynamicArray
+TEST(InlineStorageTest, SmallArraysDoNotAllocate) {
+    AllocationStats stats;
+    {
+        using Array = DynamicArray<std::string, CountingAllocator<std::string>, 4>;
+        CountingAllocator<std::string> allocator(&stats);
+        Array array(allocator);
+        EXPECT_EQ(array.GetCapacity(), 4);
+        for (int i = 0; i < 4; ++i) {
+            array.PushBack(std::to_string(i));
+        }
+        Array copy(array);
+        Array moved(std::move(copy));
+        EXPECT_EQ(stats.allocations, 0);
+        EXPECT_EQ(moved[3], "3");
+        EXPECT_EQ(copy.GetSize(), 0);
+
+        array.PushBack("4");
+        EXPECT_EQ(stats.allocations, 1);
+        EXPECT_EQ(array[0], "0");
+        Array stolen(std::move(array));
+        EXPECT_EQ(stats.allocations, 1);
+        EXPECT_EQ(stolen[4], "4");
+
+        stolen.PopBack();
+        stolen.ShrinkToFit();
+        EXPECT_EQ(stats.deallocations, 1);
+        EXPECT_EQ(stolen.GetCapacity(), 4);
+        EXPECT_EQ(stolen[3], "3");
+
+        moved = std::move(stolen);
+        EXPECT_EQ(moved[2], "2");
+    }
+    EXPECT_EQ(stats.allocations, stats.deallocations);
+}
+
+TEST(InlineStorageTest, SmallStacksAndSequences) {
+    AllocationStats stats;
+    CountingAllocator<int> allocator(&stats);
+    Stack<int, CountingAllocator<int>, 16> stack(allocator);
+    for (int i = 0; i < 16; ++i) {
+        stack.Push(i);
+    }
+    EXPECT_EQ(stack.Pop().getValue(), 15);
+    ArraySequence<int, CountingAllocator<int>, 8> sequence(allocator);
+    sequence.Append(2);
+    sequence.Prepend(1);
+    EXPECT_EQ(sequence.Get(0), 1);
+    EXPECT_EQ(stats.allocations, 0);
+}
+
+// Тесты для непроверяемого доступа к буферу
+TEST(BoundsCheckTest, DataAccessAndCheckedAccessors) {
+    int raw[] = {1, 2, 3};
+    DynamicArray<int> array(raw, 3);
+    array.Data()[1] = 20;
+    EXPECT_EQ(array[1], 20);
+    // TestsUnchecked собирается с BOUNDS_CHECK=0: там выход за границы -
+    // неопределённое поведение, и проверяется только остальное
+    if (BoundsCheckEnabled) {
+        EXPECT_THROW(array.Get(3), IndexOutOfRangeException);
+        EXPECT_THROW(array[-1], IndexOutOfRangeException);
+    }
+
+    SquareMatrix<int> matrix(2, 1);
+    matrix.AddRowMultiple(0, 1, 3);
+    EXPECT_EQ(matrix.Get(0, 1), 4);
+    if (BoundsCheckEnabled) {
+        EXPECT_THROW(matrix.Get(2, 0), IndexOutOfRangeException);
+    }
+
+    ArraySequence<int> sequence(raw, 3);
+    Sequence<int>* doubled = sequence.Map(multiplyByTwo);
+    EXPECT_EQ(doubled->GetLast(), 6);
+    EXPECT_EQ(sequence.Reduce(sum, 0), 6);
+    delete doubled;
+}
+
+// Тесты для доступа по ссылке
+TEST(ReferenceAccessTest, ScansDoNotCopyElements) {
+    ArraySequence<CopyCounter> array;
+    ListSequence<CopyCounter> list;
+    Queue<CopyCounter> queue;
+    for (int i = 0; i < 10; ++i) {
+        array.EmplaceBack(i);
+        list.EmplaceBack(i);
+        queue.Emplace(i);
+    }
+
+    CopyCounter::copies = 0;
+    Sequence<CopyCounter>* sequences[] = {&array, &list};
+    for (Sequence<CopyCounter>* sequence : sequences) {
+        EXPECT_EQ(sequence->At(3).value, 3);
+        EXPECT_EQ(sequence->FirstRef().value, 0);
+        EXPECT_EQ(sequence->LastRef().value, 9);
+        EXPECT_EQ(&sequence->At(2), &sequence->At(2));
+
+        IEnumerator<CopyCounter>* enumerator = sequence->GetEnumerator();
+        int total = 0;
+        while (enumerator->MoveNext()) {
+            total += enumerator->Current().value;
+        }
+        delete enumerator;
+        EXPECT_EQ(total, 45);
+    }
+    IEnumerator<CopyCounter>* enumerator = queue.GetEnumerator();
+    while (enumerator->MoveNext()) {
+        EXPECT_GE(enumerator->Current().value, 0);
+    }
+    delete enumerator;
+    EXPECT_EQ(CopyCounter::copies, 0);
+
+    EXPECT_THROW(list.At(10), IndexOutOfRangeException);
+    EXPECT_THROW(ListSequence<int>().FirstRef(), EmptySequenceException);
+}
+
+TEST(ReferenceAccessTest, OptionValueAccess) {
+    Option<std::string> some = Option<std::string>::Some("value");
+    const std::string& ref = some.getValue();
+    EXPECT_EQ(&ref, &some.getValue());
+    some.getValue() += "!";
+    EXPECT_EQ(some.getValue(), "value!");
+
+    std::string moved = Option<std::string>::Some("temporary").getValue();
+    EXPECT_EQ(moved, "temporary");
+    EXPECT_THROW(Option<int>::None().getValue(), InvalidArgumentException);
+}
+
+// Тесты для блочных вставки и удаления DynamicArray
+TEST(BulkEditTest, InsertAndEraseRanges) {
+    int raw[] = {1, 2, 3, 4, 5};
+    DynamicArray<int> numbers(raw, 5);
+    numbers.InsertRange(2, raw, 3);
+    numbers.EraseRange(0, 1);
+    numbers.EmplaceAt(0, 0);
+    int expected[] = {0, 2, 1, 2, 3, 3, 4, 5};
+    ASSERT_EQ(numbers.GetSize(), 8);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(numbers[i], expected[i]);
+    }
+    numbers.InsertRange(8, numbers.Data(), 8);
+    EXPECT_EQ(numbers.GetSize(), 16);
+    EXPECT_EQ(numbers[15], 5);
+    EXPECT_THROW(numbers.EraseRange(10, 7), IndexOutOfRangeException);
+    EXPECT_THROW(numbers.InsertRange(17, raw, 1), IndexOutOfRangeException);
+
+    std::string words[] = {"a", "b", "c"};
+    DynamicArray<std::string> strings(words, 3);
+    strings.InsertRange(1, words, 3);
+    strings.EraseRange(3, 2);
+    strings.EmplaceAt(1, "x");
+    std::string expectedWords[] = {"a", "x", "a", "b", "c"};
+    ASSERT_EQ(strings.GetSize(), 5);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(strings[i], expectedWords[i]);
+    }
+}
+
+TEST(BulkEditTest, ArraySequenceUsesRangePrimitives) {
+    ArraySequence<PersonID> ids;
+    for (int i = 0; i < 100; ++i) {
+        ids.Prepend(PersonID{1, i});
+    }
+    EXPECT_EQ(ids.Get(0).number, 99);
+    EXPECT_EQ(ids.Get(99).number, 0);
+    ids.RemoveRange(10, 80);
+    EXPECT_EQ(ids.GetLength(), 20);
+    EXPECT_EQ(ids.Get(10).number, 9);
+
+    Sequence<PersonID>* middle = ids.GetSubsequence(5, 14);
+    EXPECT_EQ(middle->GetLength(), 10);
+    EXPECT_EQ(middle->GetFirst().number, 94);
+    delete middle;
+
+    ImmutableArraySequence<int> frozen;
+    int raw[] = {1};
+    EXPECT_THROW(frozen.InsertRange(0, raw, 1), InvalidOperationException);
+}
+
+TEST(BulkEditTest, EmptyEraseKeepsElements) {
+    ArraySequence<std::string> words;
+    for (int i = 0; i < 6; ++i) {
+        words.Append(std::string(40, static_cast<char>('a' + i)));
+    }
+    // стирание пустого диапазона ближе к концу сдвигает хвост,
+    // ближе к началу - голову
+    words.RemoveRange(4, 0);
+    words.RemoveRange(1, 0);
+    ASSERT_EQ(words.GetLength(), 6);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(words.Get(i), std::string(40, static_cast<char>('a' + i)));
+    }
+}
+
+// Тесты для 64-битных индексов; требуют ~2.2 ГБ памяти, поэтому
+// запускаются только при заданной переменной окружения LARGE_TESTS
+TEST(LargeIndexTest, SequencesPastInt32Limit) {
+    if (sizeof(IndexType) < 8) {
+        GTEST_SKIP() << "IndexType is narrower than 64 bits";
+    }
+    if (!std::getenv("LARGE_TESTS")) {
+        GTEST_SKIP() << "Set LARGE_TESTS=1 to run";
+    }
+    const IndexType count = (IndexType(1) << 31) + 16;
+    try {
+        DynamicArray<unsigned char> bytes;
+        bytes.Resize(count, 1);
+        bytes[count - 1] = 7;
+        ArraySequence<unsigned char> sequence(std::move(bytes));
+        ASSERT_EQ(sequence.GetLength(), count);
+
+        IndexType total = 0;
+        IEnumerator<unsigned char>* enumerator = sequence.GetEnumerator();
+        while (enumerator->MoveNext()) {
+            total += enumerator->Current();
+        }
+        delete enumerator;
+        EXPECT_EQ(total, count + 6);
+        EXPECT_EQ(sequence.At(count - 1), 7);
+
+        Sequence<unsigned char>* tail = sequence.GetSubsequence(count - 4, count - 1);
+        EXPECT_EQ(tail->GetLength(), 4);
+        EXPECT_EQ(tail->GetLast(), 7);
+        delete tail;
+    } catch (const std::bad_alloc&) {
+        GTEST_SKIP() << "Not enough memory";
+    }
+}
+
+// Тесты для хвостового указателя
+TEST(TailPointerTest, TailFollowsEveryMutation) {
+    LinkedList<int> list;
+    list.Prepend(2);
+    EXPECT_EQ(list.GetLast(), 2);
+    list.InsertAt(3, 1);
+    EXPECT_EQ(list.GetLast(), 3);
+    list.InsertAt(1, 0);
+    list.Append(4);
+    EXPECT_EQ(list.GetLast(), 4);
+
+    LinkedList<int> copy(list);
+    copy.Append(5);
+    EXPECT_EQ(copy.GetLast(), 5);
+    EXPECT_EQ(copy.GetSize(), 5);
+
+    LinkedList<int> moved(std::move(copy));
+    moved.Append(6);
+    EXPECT_EQ(moved.GetLast(), 6);
+    copy.Append(7);
+    EXPECT_EQ(copy.GetFirst(), 7);
+    EXPECT_EQ(copy.GetLast(), 7);
+
+    list.Clear();
+    EXPECT_THROW(list.GetLast(), EmptySequenceException);
+    list.Append(8);
+    EXPECT_EQ(list.GetFirst(), 8);
+    EXPECT_EQ(list.GetLast(), 8);
+    list = moved;
+    EXPECT_EQ(list.GetLast(), 6);
+}
+
+TEST(TailPointerTest, AdaptersAppendAfterPops) {
+    Queue<int> queue;
+    Deque<int> deque;
+    for (int i = 0; i < 5; ++i) {
+        queue.Enqueue(i);
+        deque.PushBack(i);
+    }
+    // опустошение и повторное добавление: хвост должен сброситься и ожить
+    while (queue.Dequeue().isSome()) {
+    }
+    while (deque.PopBack().isSome()) {
+    }
+    queue.Enqueue(10);
+    queue.Enqueue(11);
+    deque.PushBack(10);
+    deque.PushFront(9);
+    deque.PushBack(11);
+    EXPECT_EQ(queue.Dequeue().getValue(), 10);
+    queue.Enqueue(12);
+    EXPECT_EQ(queue.GetSize(), 2);
+    EXPECT_EQ(queue.Dequeue().getValue(), 11);
+    EXPECT_EQ(queue.Dequeue().getValue(), 12);
+    EXPECT_EQ(deque.PeekBack().getValue(), 11);
+    EXPECT_EQ(deque.PopBack().getValue(), 11);
+    EXPECT_EQ(deque.PeekBack().getValue(), 10);
+    EXPECT_EQ(deque.PopFront().getValue(), 9);
+    EXPECT_EQ(deque.PeekBack().getValue(), 10);
+}
+
+// Тесты для двусвязного списка: удаление с обоих концов и по курсору
+TEST(DoublyLinkedListTest, RemoveAndCursorEdits) {
+    LinkedList<std::string> list;
+    for (const char* word : {"b", "c", "d"}) {
+        list.Append(word);
+    }
+    LinkedList<std::string>::Cursor cursor = list.InsertAfter(LinkedList<std::string>::Cursor(), "a");
+    EXPECT_EQ(list.GetFirst(), "a");
+    cursor.MoveNext();
+    cursor = list.InsertAfter(cursor, "bb");
+    EXPECT_EQ(list.Get(2), "bb");
+    cursor = list.Erase(cursor);
+    EXPECT_EQ(cursor.Get(), "c");
+    cursor = list.Erase(list.Last());
+    EXPECT_FALSE(cursor.IsValid());
+    EXPECT_THROW(cursor.Get(), InvalidStateException);
+    EXPECT_EQ(list.GetLast(), "c");
+    list.InsertAfter(list.Last(), "e");
+
+    EXPECT_EQ(list.RemoveFirst(), "a");
+    EXPECT_EQ(list.RemoveLast(), "e");
+    EXPECT_EQ(list.GetSize(), 2);
+    EXPECT_EQ(list.At(1), "c");
+
+    std::string backwards;
+    for (auto it = list.Last(); it.IsValid(); it.MovePrev()) {
+        backwards += it.Get();
+    }
+    EXPECT_EQ(backwards, "cb");
+
+    list.RemoveLast();
+    list.RemoveFirst();
+    EXPECT_THROW(list.RemoveFirst(), EmptySequenceException);
+    EXPECT_THROW(list.RemoveLast(), EmptySequenceException);
+    list.Append("z");
+    EXPECT_EQ(list.GetFirst(), "z");
+
+    ImmutableListSequence<int> frozen;
+    EXPECT_THROW(frozen.RemoveFirst(), InvalidOperationException);
+
+    PriorityQueue<int> pq;
+    pq.Enqueue(1, 1);
+    pq.Enqueue(2, 5);
+    pq.Enqueue(3, 1);
+    pq.Enqueue(4, 5);
+    const int expected[] = {2, 4, 1, 3};
+    for (int value : expected) {
+        EXPECT_EQ(pq.Dequeue().getValue(), value);
+    }
+}
+
+// Снятие элемента не перестраивает хранилище: за всё опустошение
+// аллокатор не вызывается ни разу
+TEST(DoublyLinkedListTest, PopsDoNotAllocate) {
+    AllocationStats stats;
+    CountingAllocator<int> allocator(&stats);
+    Queue<int, CountingAllocator<int>> queue(allocator);
+    Deque<int, CountingAllocator<int>> deque(allocator);
+    PriorityQueue<int, CountingAllocator<int>> pq(allocator);
+    for (int i = 0; i < 1000; ++i) {
+        queue.Enqueue(i);
+        deque.PushBack(i);
+        pq.Enqueue(i, -(i / 4));
+    }
+    int before = stats.allocations;
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(queue.Dequeue().getValue(), i);
+        EXPECT_EQ(pq.Dequeue().getValue(), i);
+    }
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_EQ(deque.PopFront().getValue(), i);
+        EXPECT_EQ(deque.PopBack().getValue(), 999 - i);
+    }
+    EXPECT_EQ(stats.allocations, before);
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_TRUE(deque.IsEmpty());
+    EXPECT_TRUE(pq.IsEmpty());
+}
+
+// Тесты для обхода списков по узлам
+TEST(NodeWalkTest, ListAlgorithmsMatchIndexedResults) {
+    ListSequence<int> sequence;
+    for (int i = 0; i < 10; ++i) {
+        sequence.Append(i);
+    }
+    Sequence<int>* slice = sequence.Slice(2, 3, &sequence);
+    EXPECT_EQ(slice->GetLength(), 17);
+    EXPECT_EQ(slice->Get(1), 1);
+    EXPECT_EQ(slice->Get(2), 0);
+    EXPECT_EQ(slice->Get(11), 9);
+    EXPECT_EQ(slice->Get(12), 5);
+    EXPECT_EQ(slice->GetLast(), 9);
+    delete slice;
+
+    Sequence<int>* middle = sequence.GetSubsequence(3, 6);
+    EXPECT_EQ(middle->GetFirst(), 3);
+    EXPECT_EQ(middle->GetLast(), 6);
+    Sequence<int>* joined = middle->Concat(&sequence);
+    EXPECT_EQ(joined->GetLength(), 14);
+    EXPECT_EQ(joined->Get(4), 0);
+    delete joined;
+    delete middle;
+
+    ImmutableListSequence<int> frozen(sequence);
+    Sequence<int>* frozenSlice = frozen.Slice(-2, 5);
+    EXPECT_EQ(frozenSlice->GetLength(), 8);
+    EXPECT_EQ(frozenSlice->GetLast(), 7);
+    delete frozenSlice;
+
+    Deque<int> deque;
+    for (int value : {5, 1, 4, 2, 3}) {
+        deque.PushBack(value);
+    }
+    deque.Sort();
+    int expected = 1;
+    IEnumerator<int>* enumerator = deque.GetEnumerator();
+    while (enumerator->MoveNext()) {
+        EXPECT_EQ(enumerator->Current(), expected++);
+    }
+    EXPECT_FALSE(enumerator->MoveNext());
+    EXPECT_THROW(enumerator->Current(), InvalidStateException);
+    enumerator->Reset();
+    EXPECT_TRUE(enumerator->MoveNext());
+    EXPECT_EQ(enumerator->Current(), 1);
+    delete enumerator;
+}
+
+TEST(NodeWalkTest, ReduceAndEnumeratorVisitEveryNode) {
+    ListSequence<int> sequence;
+    for (int i = 0; i < 1000; ++i) {
+        sequence.Append(i);
+    }
+    sequence.RemoveFirst();
+    sequence.Prepend(-1);
+    sequence.RemoveLast();
+    EXPECT_EQ(sequence.Reduce(sum, 0), 998 * 999 / 2 - 1);
+    IEnumerator<int>* enumerator = sequence.GetEnumerator();
+    IndexType seen = 0;
+    int previous = -2;
+    while (enumerator->MoveNext()) {
+        EXPECT_LT(previous, enumerator->Current());
+        previous = enumerator->Current();
+        ++seen;
+    }
+    delete enumerator;
+    EXPECT_EQ(seen, 999);
+}
+
+// Тесты для пальца списка: доступ по соседним индексам не идёт от головы
+TEST(FingerTest, IndexedAccessAfterEdits) {
+    LinkedList<int> list;
+    for (int i = 0; i < 100; ++i) {
+        list.Append(i);
+    }
+    EXPECT_EQ(list.Get(40), 40);
+    EXPECT_EQ(list.Get(41), 41);
+    EXPECT_EQ(list.Get(39), 39);
+    list.InsertAt(-1, 40);
+    EXPECT_EQ(list.Get(40), -1);
+    EXPECT_EQ(list.Get(41), 40);
+    list.InsertAt(-2, 41);
+    EXPECT_EQ(list.Get(42), 40);
+    list.RemoveFirst();
+    EXPECT_EQ(list.Get(39), -1);
+    EXPECT_EQ(list.Get(41), 40);
+    list.Erase(list.First());
+    EXPECT_EQ(list.Get(39), -2);
+
+    LinkedList<int> moved(std::move(list));
+    EXPECT_EQ(moved.Get(38), -1);
+    EXPECT_EQ(moved.Get(moved.GetSize() - 1), 99);
+    list.Append(7);
+    EXPECT_EQ(list.Get(0), 7);
+    moved.Clear();
+    moved.Append(8);
+    EXPECT_EQ(moved.Get(0), 8);
+}
+
+TEST(FingerTest, MatchesArrayUnderMixedEdits) {
+    LinkedList<int> list;
+    DynamicArray<int> reference;
+    unsigned state = 12345;
+    auto next = [&state](IndexType bound) {
+        state = state * 1103515245u + 12345u;
+        return static_cast<IndexType>((state >> 8) % static_cast<unsigned>(bound));
+    };
+    for (int step = 0; step < 3000; ++step) {
+        IndexType size = reference.GetSize();
+        switch (next(5)) {
+        case 0:
+        case 1: {
+            IndexType index = next(size + 1);
+            list.InsertAt(step, index);
+            reference.EmplaceAt(index, step);
+            break;
+        }
+        case 2:
+            if (size > 0) {
+                list.RemoveFirst();
+                reference.EraseRange(0, 1);
+            }
+            break;
+        case 3:
+            if (size > 0) {
+                list.RemoveLast();
+                reference.PopBack();
+            }
+            break;
+        default:
+            if (size > 0) {
+                // соседние индексы идут через палец, дальние - от концов
+                IndexType index = next(size);
+                ASSERT_EQ(list.Get(index), reference[index]);
+                ASSERT_EQ(list.At(std::min(index + 1, size - 1)), reference[std::min(index + 1, size - 1)]);
+                ASSERT_EQ(list.Get(index > 0 ? index - 1 : 0), reference[index > 0 ? index - 1 : 0]);
+            }
+        }
+        ASSERT_EQ(list.GetSize(), reference.GetSize());
+    }
+}
+
+// Тесты для развёрнутого списка как хранилища ListSequence, Queue и Deque
+TEST(UnrolledListTest, MatchesLinkedListUnderMixedEdits) {
+    UnrolledLinkedList<std::string> unrolled;
+    LinkedList<std::string> reference;
+    unsigned state = 12345;
+    for (int step = 0; step < 4000; ++step) {
+        state = state * 1103515245u + 12345u;
+        unsigned choice = (state >> 16) % 6;
+        std::string value(1 + step % 20, static_cast<char>('a' + step % 26));
+        if (choice == 0) {
+            unrolled.Append(value);
+            reference.Append(value);
+        } else if (choice == 1) {
+            unrolled.Prepend(value);
+            reference.Prepend(value);
+        } else if (choice == 2) {
+            IndexType index = static_cast<IndexType>((state >> 8) % (reference.GetSize() + 1));
+            unrolled.InsertAt(value, index);
+            reference.InsertAt(value, index);
+        } else if (reference.GetSize() > 0 && choice == 3) {
+            EXPECT_EQ(unrolled.RemoveFirst(), reference.RemoveFirst());
+        } else if (reference.GetSize() > 0 && choice == 4) {
+            EXPECT_EQ(unrolled.RemoveLast(), reference.RemoveLast());
+        } else if (reference.GetSize() > 0) {
+            IndexType index = static_cast<IndexType>((state >> 8) % reference.GetSize());
+            auto unrolledCursor = unrolled.First();
+            auto referenceCursor = reference.First();
+            for (IndexType i = 0; i < index; ++i) {
+                unrolledCursor.MoveNext();
+                referenceCursor.MoveNext();
+            }
+            unrolledCursor = unrolled.Erase(unrolledCursor);
+            referenceCursor = reference.Erase(referenceCursor);
+            ASSERT_EQ(unrolledCursor.IsValid(), referenceCursor.IsValid());
+            if (referenceCursor.IsValid()) {
+                EXPECT_EQ(unrolledCursor.Get(), referenceCursor.Get());
+            }
+        }
+        ASSERT_EQ(unrolled.GetSize(), reference.GetSize());
+    }
+    auto backwards = unrolled.Last();
+    for (IndexType i = reference.GetSize() - 1; i >= 0; --i, backwards.MovePrev()) {
+        ASSERT_EQ(unrolled.At(i), reference.At(i));
+        ASSERT_EQ(backwards.Get(), reference.At(i));
+    }
+    EXPECT_FALSE(backwards.IsValid());
+
+    UnrolledLinkedList<std::string> copy(unrolled);
+    unrolled.Clear();
+    EXPECT_EQ(copy.GetSize(), reference.GetSize());
+    EXPECT_THROW(unrolled.GetFirst(), EmptySequenceException);
+}
+
+TEST(UnrolledListTest, SelectableBackend) {
+    ListSequence<int, std::allocator<int>, UnrolledLinkedList> sequence;
+    for (int i = 0; i < 1000; ++i) {
+        sequence.Append(i);
+    }
+    EXPECT_EQ(sequence.Reduce(sum, 0), 499500);
+    Sequence<int>* evens = sequence.Where(isEven);
+    EXPECT_EQ(evens->GetLength(), 500);
+    delete evens;
+    EXPECT_EQ(sequence.RemoveFirst(), 0);
+    EXPECT_EQ(sequence.Get(500), 501);
+
+    Queue<int, std::allocator<int>, UnrolledLinkedList> queue;
+    Deque<int, std::allocator<int>, UnrolledLinkedList> deque;
+    for (int i = 0; i < 300; ++i) {
+        queue.Enqueue(i);
+        deque.PushFront(i);
+    }
+    for (int i = 0; i < 300; ++i) {
+        EXPECT_EQ(queue.Dequeue().getValue(), i);
+        EXPECT_EQ(deque.PopBack().getValue(), i);
+    }
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_TRUE(deque.IsEmpty());
+
+    AllocationStats stats;
+    {
+        CountingAllocator<int> allocator(&stats);
+        ListSequence<int, CountingAllocator<int>, UnrolledLinkedList> counted(allocator);
+        for (int i = 0; i < 1000; ++i) {
+            counted.Append(i);
+        }
+        EXPECT_LT(stats.allocations, 10);
+    }
+    EXPECT_EQ(stats.allocations, stats.deallocations);
+}
+
+// Тесты для переноса узлов между списками
+TEST(SpliceTest, NodesMoveWithoutCopying) {
+    LinkedList<std::string> first;
+    LinkedList<std::string> second;
+    for (int i = 0; i < 40; ++i) {
+        first.Append("a" + std::to_string(i));
+        second.Append("b" + std::to_string(i));
+    }
+    auto cursor = first.First();
+    cursor.MoveNext();
+    {
+        LinkedList<std::string> middle;
+        middle.Append("m");
+        first.Splice(cursor, middle);
+        EXPECT_EQ(middle.GetSize(), 0);
+        middle.Append("unused");
+    }
+    EXPECT_EQ(first.Get(2), "m");
+    EXPECT_EQ(first.Get(3), "a2");
+    first.AppendList(second);
+    EXPECT_EQ(first.GetSize(), 81);
+    EXPECT_EQ(first.GetLast(), "b39");
+    EXPECT_EQ(second.GetSize(), 0);
+    EXPECT_THROW(second.GetLast(), EmptySequenceException);
+    second.Append("again");
+    first.Splice(LinkedList<std::string>::Cursor(), second);
+    EXPECT_EQ(first.GetFirst(), "again");
+    EXPECT_EQ(first.Last().Get(), "b39");
+    EXPECT_EQ(first.RemoveLast(), "b39");
+
+    UnrolledLinkedList<std::string> unrolled;
+    UnrolledLinkedList<std::string> other;
+    for (int i = 0; i < 20; ++i) {
+        unrolled.Append(std::to_string(i));
+        other.Append("x");
+    }
+    auto position = unrolled.First();
+    position.MoveNext();
+    unrolled.Splice(position, other);
+    EXPECT_EQ(unrolled.GetSize(), 40);
+    EXPECT_EQ(unrolled.Get(1), "1");
+    EXPECT_EQ(unrolled.Get(2), "x");
+    EXPECT_EQ(unrolled.Get(22), "2");
+    EXPECT_EQ(unrolled.GetLast(), "19");
+}
+
+TEST(SpliceTest, ConcatInPlaceOnContainers) {
+    Queue<int> merged;
+    for (int worker = 0; worker < 4; ++worker) {
+        Queue<int> local;
+        for (int i = 0; i < 5; ++i) {
+            local.Enqueue(worker * 5 + i);
+        }
+        merged.ConcatInPlace(local);
+        EXPECT_TRUE(local.IsEmpty());
+    }
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(merged.Dequeue().getValue(), i);
+    }
+
+    Deque<int, std::allocator<int>, UnrolledLinkedList> left;
+    Deque<int, std::allocator<int>, UnrolledLinkedList> right;
+    left.PushBack(1);
+    right.PushBack(2);
+    left.ConcatInPlace(right);
+    EXPECT_EQ(left.PopBack().getValue(), 2);
+    EXPECT_TRUE(right.IsEmpty());
+
+    AllocationStats firstStats;
+    AllocationStats secondStats;
+    {
+        ListSequence<int, CountingAllocator<int>> a{CountingAllocator<int>(&firstStats)};
+        ListSequence<int, CountingAllocator<int>> b{CountingAllocator<int>(&secondStats)};
+        a.Append(1);
+        b.Append(2);
+        a.ConcatInPlace(b);
+        EXPECT_EQ(a.GetLast(), 2);
+        EXPECT_EQ(b.GetLength(), 0);
+    }
+    EXPECT_EQ(firstStats.allocations, firstStats.deallocations);
+    EXPECT_EQ(secondStats.allocations, secondStats.deallocations);
+
+    ImmutableListSequence<int> frozen;
+    ListSequence<int> source;
+    EXPECT_THROW(frozen.ConcatInPlace(source), InvalidOperationException);
+
+    // неизменяемый донор не отдаёт узлы
+    int raw[] = {1, 2, 3};
+    ImmutableListSequence<int> donor(raw, 3);
+    EXPECT_THROW(source.ConcatInPlace(donor), InvalidOperationException);
+    EXPECT_EQ(donor.GetLength(), 3);
+    EXPECT_EQ(source.GetLength(), 0);
+}
+
+TEST(SpliceTest, AdoptedFreeCapacityIsReused) {
+    AllocationStats stats;
+    CountingAllocator<int> allocator(&stats);
+    LinkedList<int, CountingAllocator<int>> merged(allocator);
+    LinkedList<int, CountingAllocator<int>> donor(allocator);
+    const int Rounds = 200;
+    int next = 0;
+    for (int round = 0; round < Rounds; ++round) {
+        // донор берёт блок из 16 узлов: один занят, половина освобождена
+        // удалениями, остальные не тронуты
+        for (int i = 0; i < 9; ++i) {
+            donor.Append(next + i);
+        }
+        for (int i = 0; i < 8; ++i) {
+            donor.RemoveLast();
+        }
+        merged.AppendList(donor);
+        ++next;
+        // свободные ячейки и остаток блока донора заполняются без выделений
+        for (int i = 0; i < 15; ++i) {
+            merged.Append(next++);
+        }
+    }
+    EXPECT_EQ(stats.allocations, Rounds);
+    ASSERT_EQ(merged.GetSize(), 16 * Rounds);
+    int expected = 0;
+    for (auto cursor = merged.First(); cursor.IsValid(); cursor.MoveNext()) {
+        ASSERT_EQ(cursor.Get(), expected++);
+    }
+}
+
+// Тесты для последовательности с разрывом
+TEST(GapBufferTest, EditsAroundCursor) {
+    GapBufferSequence<std::string> text;
+    ArraySequence<std::string> reference;
+    IndexType cursor = 0;
+    unsigned state = 7;
+    for (int step = 0; step < 2000; ++step) {
+        state = state * 1103515245u + 12345u;
+        unsigned choice = (state >> 16) % 5;
+        IndexType length = reference.GetLength();
+        if (choice == 0 && cursor > 0) {
+            --cursor;
+        } else if (choice == 1 && cursor < length) {
+            ++cursor;
+        } else if (choice == 2 && cursor < length) {
+            std::string removed = text.RemoveAt(cursor);
+            EXPECT_EQ(removed, reference.Get(cursor));
+            reference.RemoveRange(cursor, 1);
+        } else {
+            std::string word = std::to_string(step);
+            text.InsertAt(word, cursor);
+            reference.InsertAt(word, cursor);
+            ++cursor;
+        }
+        ASSERT_EQ(text.GetLength(), reference.GetLength());
+    }
+    for (IndexType i = 0; i < reference.GetLength(); ++i) {
+        ASSERT_EQ(text.At(i), reference.At(i));
+    }
+    text.Append("end");
+    text.Prepend("begin");
+    EXPECT_EQ(text.GetFirst(), "begin");
+    EXPECT_EQ(text.GetLast(), "end");
+    EXPECT_EQ(text.GetGapPosition(), 1);
+    EXPECT_THROW(text.MoveGap(text.GetLength() + 1), IndexOutOfRangeException);
+    EXPECT_THROW(text.RemoveAt(text.GetLength()), IndexOutOfRangeException);
+}
+
+TEST(GapBufferTest, InsertsElementTakenFromItself) {
+    GapBufferSequence<std::string> sequence;
+    for (char c = 'a'; c < 'g'; ++c) {
+        sequence.Append(std::string(40, c));
+    }
+    sequence.InsertAt(std::string(40, 'z'), 0);
+    // вставка по ссылке на элемент, который MoveGap переносит через разрыв
+    sequence.InsertAt(sequence.At(4), 5);
+    EXPECT_EQ(sequence.Get(5), std::string(40, 'd'));
+    sequence.Append(sequence.At(0));
+    EXPECT_EQ(sequence.GetLast(), std::string(40, 'z'));
+    sequence.Prepend(sequence.At(7));
+    EXPECT_EQ(sequence.GetFirst(), std::string(40, 'f'));
+    EXPECT_EQ(sequence.GetLength(), 10);
+}
+
+TEST(GapBufferTest, HigherOrderFunctionsSeeLogicalOrder) {
+    int items[] = {1, 2, 3, 4, 5, 6};
+    GapBufferSequence<int> sequence(items, 6);
+    sequence.MoveGap(3);
+    sequence.InsertAt(10, 3);
+
+    Sequence<int>* doubled = sequence.Map(multiplyByTwo);
+    EXPECT_EQ(doubled->Get(3), 20);
+    EXPECT_EQ(doubled->Get(6), 12);
+    delete doubled;
+    EXPECT_EQ(sequence.Reduce(sum, 0), 31);
+    EXPECT_EQ(sequence.Find(isEven).getValue(), 2);
+
+    auto [evens, odds] = sequence.Split(isEven);
+    EXPECT_EQ(evens->GetLength(), 4);
+    EXPECT_EQ(evens->Get(1), 10);
+    EXPECT_EQ(odds->GetLast(), 5);
+    delete evens;
+    delete odds;
+
+    Sequence<int>* middle = sequence.GetSubsequence(2, 4);
+    EXPECT_EQ(middle->Get(1), 10);
+    Sequence<int>* sliced = sequence.Slice(1, 2, middle);
+    EXPECT_EQ(sliced->GetLength(), 8);
+    EXPECT_EQ(sliced->Get(1), 3);
+    EXPECT_EQ(sliced->Get(4), 10);
+    delete sliced;
+    Sequence<int>* joined = sequence.Concat(middle);
+    EXPECT_EQ(joined->GetLast(), 4);
+    delete joined;
+    delete middle;
+
+    int expected[] = {1, 2, 3, 10, 4, 5, 6};
+    int index = 0;
+    IEnumerator<int>* enumerator = sequence.GetEnumerator();
+    while (enumerator->MoveNext()) {
+        EXPECT_EQ(enumerator->Current(), expected[index++]);
+    }
+    EXPECT_EQ(index, 7);
+    delete enumerator;
+}
+
+// Тесты для верёвки
+TEST(RopeTest, EditsMatchArraySequence) {
+    RopeSequence<int> rope;
+    ArraySequence<int> reference;
+    unsigned state = 99;
+    for (int step = 0; step < 3000; ++step) {
+        state = state * 1103515245u + 12345u;
+        IndexType index = static_cast<IndexType>((state >> 8) % (reference.GetLength() + 1));
+        if ((state >> 16) % 4 == 0) {
+            rope.Prepend(step);
+            reference.Prepend(step);
+        } else if ((state >> 16) % 4 == 1) {
+            rope.Append(step);
+            reference.Append(step);
+        } else {
+            rope.InsertAt(step, index);
+            reference.InsertAt(step, index);
+        }
+    }
+    ASSERT_EQ(rope.GetLength(), reference.GetLength());
+    IEnumerator<int>* enumerator = rope.GetEnumerator();
+    for (IndexType i = 0; i < reference.GetLength(); ++i) {
+        ASSERT_TRUE(enumerator->MoveNext());
+        ASSERT_EQ(enumerator->Current(), reference.At(i));
+        ASSERT_EQ(rope.At(i), reference.At(i));
+    }
+    EXPECT_FALSE(enumerator->MoveNext());
+    delete enumerator;
+    // высота AVL-дерева не больше 1.44 * log2(число листьев) + 2
+    EXPECT_LE(rope.GetHeight(), 20);
+    EXPECT_EQ(rope.Reduce(sum, 0), reference.Reduce(sum, 0));
+}
+
+TEST(RopeTest, AppendCopiesAtMostMergeCapacity) {
+    using Rope = RopeSequence<CopyCounter>;
+    const int Count = 4096;
+    Rope rope;
+    CopyCounter::copies = 0;
+    for (int i = 0; i < Count; ++i) {
+        rope.Append(CopyCounter(2 * i + 1));
+        rope.Prepend(CopyCounter(-2 * i));
+    }
+    // при слиянии до LeafCapacity каждое добавление копировало бы
+    // в среднем пол-листа
+    EXPECT_LE(CopyCounter::copies, 2LL * Count * Rope::MergeCapacity);
+    ASSERT_EQ(rope.GetLength(), 2 * Count);
+    EXPECT_EQ(rope.GetFirst().value, -2 * (Count - 1));
+    EXPECT_EQ(rope.Get(Count).value, 1);
+    EXPECT_EQ(rope.GetLast().value, 2 * Count - 1);
+    EXPECT_LE(rope.GetHeight(), 20);
+}
+
+TEST(RopeTest, ConcatAndSliceShareStructure) {
+    const IndexType count = 1000000;
+    DynamicArray<int> values;
+    for (IndexType i = 0; i < count; ++i) {
+        values.PushBack(static_cast<int>(i));
+    }
+    RopeSequence<int> rope(values.Data(), count);
+    RopeSequence<int> copy(rope);
+    copy.InsertAt(-1, 10);
+    EXPECT_EQ(rope.Get(10), 10);
+    EXPECT_EQ(copy.Get(10), -1);
+
+    Sequence<int>* doubled = rope.Concat(&rope);
+    EXPECT_EQ(doubled->GetLength(), 2 * count);
+    EXPECT_EQ(doubled->Get(count + 5), 5);
+    Sequence<int>* middle = doubled->GetSubsequence(count - 3, count + 2);
+    EXPECT_EQ(middle->GetLength(), 6);
+    EXPECT_EQ(middle->GetFirst(), static_cast<int>(count - 3));
+    EXPECT_EQ(middle->GetLast(), 2);
+
+    ListSequence<int> inserted;
+    inserted.Append(-5);
+    Sequence<int>* sliced = doubled->Slice(count, count - 1, &inserted);
+    EXPECT_EQ(sliced->GetLength(), count + 2);
+    EXPECT_EQ(sliced->Get(count), -5);
+    EXPECT_EQ(sliced->GetLast(), static_cast<int>(count - 1));
+    delete sliced;
+    delete middle;
+    delete doubled;
+
+    Sequence<int>* evens = rope.Where(isEven);
+    EXPECT_EQ(evens->GetLength(), count / 2);
+    EXPECT_EQ(evens->Find(isEven).getValue(), 0);
+    delete evens;
+    auto [even, odd] = rope.Split(isEven);
+    EXPECT_EQ(odd->GetFirst(), 1);
+    delete even;
+    delete odd;
+}
+
+// Тесты для B+-дерева с размерами поддеревьев
+TEST(BTreeTest, EditsMatchArraySequence) {
+    BTreeSequence<int> tree;
+    ArraySequence<int> reference;
+    unsigned state = 7;
+    for (int step = 0; step < 20000; ++step) {
+        state = state * 1103515245u + 12345u;
+        IndexType length = reference.GetLength();
+        IndexType index = static_cast<IndexType>((state >> 8) % (length + 1));
+        unsigned action = (state >> 20) % 8;
+        if (action < 3 && length > 0) {
+            index = index % length;
+            ASSERT_EQ(tree.RemoveAt(index), reference.Get(index));
+            reference.RemoveRange(index, 1);
+        } else if (action == 3) {
+            tree.Prepend(step);
+            reference.Prepend(step);
+        } else if (action == 4) {
+            tree.Append(step);
+            reference.Append(step);
+        } else {
+            tree.InsertAt(step, index);
+            reference.InsertAt(step, index);
+        }
+    }
+    ASSERT_EQ(tree.GetLength(), reference.GetLength());
+    IEnumerator<int>* enumerator = tree.GetEnumerator();
+    for (IndexType i = 0; i < reference.GetLength(); ++i) {
+        ASSERT_TRUE(enumerator->MoveNext());
+        ASSERT_EQ(enumerator->Current(), reference.At(i));
+        ASSERT_EQ(tree.At(i), reference.At(i));
+    }
+    EXPECT_FALSE(enumerator->MoveNext());
+    delete enumerator;
+
+    // после правок листья заполнены частично, и диапазоны пересекают их границы
+    IndexType length = reference.GetLength();
+    for (IndexType start = 0; start < length; start += length / 7 + 1) {
+        IndexType end = std::min(length - 1, start + 3 * BTreeSequence<int>::LeafCapacity + 5);
+        Sequence<int>* part = tree.GetSubsequence(start, end);
+        ASSERT_EQ(part->GetLength(), end - start + 1);
+        for (IndexType i = start; i <= end; ++i) {
+            ASSERT_EQ(part->At(i - start), reference.At(i));
+        }
+        delete part;
+
+        Sequence<int>* cut = tree.Slice(start, end - start + 1);
+        ASSERT_EQ(cut->GetLength(), length - (end - start + 1));
+        for (IndexType i = 0; i < cut->GetLength(); ++i) {
+            ASSERT_EQ(cut->At(i), reference.At(i < start ? i : i + end - start + 1));
+        }
+        delete cut;
+    }
+
+    while (tree.GetLength() > 0) {
+        tree.RemoveAt(tree.GetLength() / 2);
+    }
+    EXPECT_EQ(tree.GetHeight(), 0);
+    EXPECT_THROW(tree.RemoveAt(0), IndexOutOfRangeException);
+    EXPECT_FALSE(tree.TryGetFirst().isSome());
+}
+
+TEST(BTreeTest, LargeTreeStaysShallowAndScans) {
+    const IndexType count = 1000000;
+    BTreeSequence<int> tree;
+    for (IndexType i = 0; i < count; ++i) {
+        tree.Append(static_cast<int>(i));
+    }
+    // листья заполнены целиком, поэтому высота - log по основанию 16 числа листьев
+    EXPECT_LE(tree.GetHeight(), 4);
+    EXPECT_EQ(tree.Get(123456), 123456);
+    tree.InsertAt(-1, 500000);
+    EXPECT_EQ(tree.Get(500000), -1);
+    EXPECT_EQ(tree.Get(500001), 500000);
+    EXPECT_EQ(tree.RemoveAt(500000), -1);
+
+    Sequence<int>* doubled = tree.Map(multiplyByTwo);
+    EXPECT_EQ(doubled->Get(count - 1), static_cast<int>(2 * (count - 1)));
+    delete doubled;
+    Sequence<int>* evens = tree.Where(isEven);
+    EXPECT_EQ(evens->GetLength(), count / 2);
+    delete evens;
+    EXPECT_EQ(tree.Find(isEven).getValue(), 0);
+
+    BTreeSequence<int> copy(tree);
+    copy.Prepend(-7);
+    EXPECT_EQ(copy.GetFirst(), -7);
+    EXPECT_EQ(tree.GetFirst(), 0);
+    BTreeSequence<int> moved(std::move(copy));
+    EXPECT_EQ(moved.GetLength(), count + 1);
+    EXPECT_EQ(moved.GetLast(), static_cast<int>(count - 1));
+}
+
+// Тесты для блочной последовательности
+TEST(SegmentedArrayTest, AppendKeepsAddressesAndGrowsByChunks) {
+    using Segmented = SegmentedArraySequence<int>;
+    Segmented sequence;
+    sequence.Append(42);
+    const int* firstAddress = &sequence.At(0);
+    const IndexType count = Segmented::ChunkSize * 50 + 3;
+    for (IndexType i = 1; i < count; ++i) {
+        sequence.Append(static_cast<int>(i));
+        ASSERT_EQ(sequence.GetCapacity() % Segmented::ChunkSize, 0);
+        ASSERT_LT(sequence.GetCapacity(), sequence.GetLength() + Segmented::ChunkSize + 1);
+    }
+    EXPECT_EQ(&sequence.At(0), firstAddress);
+    EXPECT_EQ(sequence.GetFirst(), 42);
+    EXPECT_EQ(sequence.Get(count - 1), static_cast<int>(count - 1));
+    EXPECT_EQ(sequence.Get(Segmented::ChunkSize), static_cast<int>(Segmented::ChunkSize));
+
+    while (sequence.GetLength() > 1) {
+        sequence.RemoveLast();
+    }
+    EXPECT_LE(sequence.GetCapacity(), 2 * Segmented::ChunkSize);
+    EXPECT_THROW(sequence.At(1), IndexOutOfRangeException);
+
+    // Reserve и Map выделяют все блоки заранее
+    Segmented reserved;
+    reserved.Reserve(count);
+    EXPECT_EQ(reserved.GetCapacity(), 51 * Segmented::ChunkSize);
+    for (IndexType i = 0; i < count; ++i) {
+        reserved.Append(static_cast<int>(i));
+    }
+    EXPECT_EQ(reserved.GetCapacity(), 51 * Segmented::ChunkSize);
+    EXPECT_THROW(reserved.Reserve(-1), InvalidSizeException);
+    Sequence<long long>* mapped = reserved.Map<long long>([](const int& x) { return 2LL * x; });
+    auto* segmented = dynamic_cast<SegmentedArraySequence<long long>*>(mapped);
+    ASSERT_NE(segmented, nullptr);
+    EXPECT_EQ(segmented->GetCapacity(), (count + SegmentedArraySequence<long long>::ChunkSize - 1)
+                                        / SegmentedArraySequence<long long>::ChunkSize
+                                        * SegmentedArraySequence<long long>::ChunkSize);
+    EXPECT_EQ(segmented->GetLast(), 2LL * (count - 1));
+    delete mapped;
+}
+
+TEST(SegmentedArrayTest, EditsAndHigherOrderFunctions) {
+    SegmentedArraySequence<int> sequence;
+    ArraySequence<int> reference;
+    for (int i = 0; i < 5000; ++i) {
+        IndexType index = (static_cast<IndexType>(i) * 7919) % (reference.GetLength() + 1);
+        sequence.InsertAt(i, index);
+        reference.InsertAt(i, index);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        IndexType index = (static_cast<IndexType>(i) * 104729) % reference.GetLength();
+        ASSERT_EQ(sequence.RemoveAt(index), reference.Get(index));
+        reference.RemoveRange(index, 1);
+    }
+    sequence.Prepend(-1);
+    reference.Prepend(-1);
+    ASSERT_EQ(sequence.GetLength(), reference.GetLength());
+    IEnumerator<int>* enumerator = sequence.GetEnumerator();
+    for (IndexType i = 0; i < reference.GetLength(); ++i) {
+        ASSERT_TRUE(enumerator->MoveNext());
+        ASSERT_EQ(enumerator->Current(), reference.At(i));
+    }
+    EXPECT_FALSE(enumerator->MoveNext());
+    delete enumerator;
+
+    EXPECT_EQ(sequence.Reduce(sum, 0), reference.Reduce(sum, 0));
+    Sequence<int>* evens = sequence.Where(isEven);
+    Sequence<int>* expected = reference.Where(isEven);
+    EXPECT_EQ(evens->GetLength(), expected->GetLength());
+    EXPECT_EQ(evens->GetLast(), expected->GetLast());
+    delete expected;
+    delete evens;
+
+    SegmentedArraySequence<int> copy(sequence);
+    copy.Append(7);
+    EXPECT_EQ(copy.GetLength(), sequence.GetLength() + 1);
+    SegmentedArraySequence<int> moved;
+    moved = std::move(copy);
+    EXPECT_EQ(moved.GetLast(), 7);
+    EXPECT_EQ(copy.GetLength(), 0);
+}
+
+// Тесты для запаса спереди DynamicArray
+// Тип, считающий перемещения, для проверки стоимости вставок
+struct MoveCounter {
+    static long long moves;
+    int value;
+
+    MoveCounter(int v = 0) : value(v) {}
+    MoveCounter(const MoveCounter& other) = default;
+    MoveCounter(MoveCounter&& other) noexcept : value(other.value) { ++moves; }
+    MoveCounter& operator=(const MoveCounter& other) = default;
+    MoveCounter& operator=(MoveCounter&& other) noexcept {
+        value = other.value;
+        ++moves;
+        return *this;
+    }
+};
+
+long long MoveCounter::moves = 0;
+
+TEST(FrontCapacityTest, PrependCostIsFlat) {
+    // со сдвигом всего хвоста на каждой вставке перемещений было бы
+    // порядка N^2 / 2, а выделений - столько же, сколько при росте в конец
+    const int Count = 1 << 16;
+    MoveCounter::moves = 0;
+    AllocationStats stats;
+    {
+        ArraySequence<MoveCounter, CountingAllocator<MoveCounter>> sequence{CountingAllocator<MoveCounter>(&stats)};
+        for (int i = 0; i < Count; ++i) {
+            sequence.Prepend(MoveCounter(i));
+        }
+        EXPECT_EQ(sequence.GetFirst().value, Count - 1);
+        EXPECT_EQ(sequence.GetLast().value, 0);
+    }
+    EXPECT_LT(MoveCounter::moves, 4LL * Count);
+    EXPECT_LE(stats.allocations, 40);
+
+    DynamicArray<int> array;
+    for (int i = 0; i < 100; ++i) {
+        array.EmplaceFront(i);
+    }
+    EXPECT_GT(array.GetFrontCapacity(), 0);
+    array.EraseRange(0, 10);
+    EXPECT_EQ(array[0], 89);
+    array.Clear();
+    EXPECT_EQ(array.GetFrontCapacity(), 0);
+}
+
+TEST(FrontCapacityTest, EditsOnBothSidesKeepOrder) {
+    DynamicArray<std::string> array;
+    BTreeSequence<std::string> reference;
+    for (int i = 0; i < 3000; ++i) {
+        IndexType length = array.GetSize();
+        IndexType index = (static_cast<IndexType>(i) * 7919) % (length + 1);
+        std::string value = std::to_string(i);
+        if (i % 5 == 4 && length > 2) {
+            index %= length - 1;
+            array.EraseRange(index, 2);
+            reference.RemoveAt(index);
+            reference.RemoveAt(index);
+        } else if (i % 7 == 0 && length > 0) {
+            // источник - элемент того же массива, который сдвигается при вставке
+            array.EmplaceAt(index / 2, array[length - 1]);
+            reference.InsertAt(reference.GetLast(), index / 2);
+        } else {
+            array.EmplaceAt(index, value);
+            reference.InsertAt(value, index);
+        }
+    }
+    ASSERT_EQ(array.GetSize(), reference.GetLength());
+    for (IndexType i = 0; i < array.GetSize(); ++i) {
+        ASSERT_EQ(array[i], reference.At(i));
+    }
+
+    DynamicArray<std::string> copy(array);
+    copy.ShrinkToFit();
+    EXPECT_EQ(copy.GetFrontCapacity(), 0);
+    EXPECT_EQ(copy.GetCapacity(), array.GetSize());
+    DynamicArray<std::string> moved(std::move(array));
+    EXPECT_EQ(moved[0], copy[0]);
+    EXPECT_EQ(array.GetSize(), 0);
+}
+
+// Тесты для HOF с произвольными вызываемыми объектами
+TEST(CallableHofTest, CapturingLambdasOnSequences) {
+    int offset = 10;
+    int threshold = 3;
+    ArraySequence<int> array;
+    for (int i = 0; i < 6; ++i) {
+        array.Append(i);
+    }
+    Sequence<int>* shifted = array.Map([offset](const int& x) { return x + offset; });
+    EXPECT_EQ(shifted->GetFirst(), 10);
+    EXPECT_EQ(shifted->GetLast(), 15);
+    delete shifted;
+    Sequence<int>* large = array.Where([&](const int& x) { return x >= threshold; });
+    EXPECT_EQ(large->GetLength(), 3);
+    delete large;
+    EXPECT_EQ(array.Reduce([](const int& a, const int& b) { return a + b; }, offset), 25);
+    EXPECT_EQ(array.Find([&](const int& x) { return x > threshold; }).getValue(), 4);
+    auto [low, high] = array.Split([&](const int& x) { return x < threshold; });
+    EXPECT_EQ(low->GetLength(), 3);
+    EXPECT_EQ(high->GetFirst(), 3);
+    delete low;
+    delete high;
+    Sequence<int>* repeated = array.FlatMap([&](const int& x) -> Sequence<int>* {
+        ListSequence<int>* copies = new ListSequence<int>();
+        for (int k = 0; k < (x < threshold ? 2 : 1); ++k) {
+            copies->Append(x);
+        }
+        return copies;
+    });
+    EXPECT_EQ(repeated->GetLength(), 9);
+    delete repeated;
+
+    ListSequence<int> list;
+    BTreeSequence<int> tree;
+    for (int i = 0; i < 6; ++i) {
+        list.Append(i);
+        tree.Append(i);
+    }
+    int calls = 0;
+    EXPECT_EQ(list.Reduce([&](const int& a, const int& b) { ++calls; return a + b; }, 0), 15);
+    EXPECT_EQ(tree.Reduce([&](const int& a, const int& b) { ++calls; return a + b; }, 0), 15);
+    EXPECT_EQ(calls, 12);
+
+    // через Sequence<T>* работают прежние перегрузки с указателями на функции
+    Sequence<int>* base = &tree;
+    Sequence<int>* doubled = base->Map(multiplyByTwo);
+    EXPECT_EQ(doubled->GetLast(), 10);
+    delete doubled;
+    EXPECT_EQ(base->Reduce(sum, 0), 15);
+
+    int values[] = {1, 2, 3};
+    ImmutableArraySequence<int> immutable(values, 3);
+    Sequence<int>* mapped = immutable.Map([offset](const int& x) { return x * offset; });
+    EXPECT_NE(dynamic_cast<ImmutableArraySequence<int>*>(mapped), nullptr);
+    EXPECT_EQ(mapped->GetLast(), 30);
+    delete mapped;
+    Sequence<int>* virtualMapped = static_cast<Sequence<int>*>(&immutable)->Map(multiplyByTwo);
+    EXPECT_NE(dynamic_cast<ImmutableArraySequence<int>*>(virtualMapped), nullptr);
+    delete virtualMapped;
+}
+
+TEST(CallableHofTest, CapturingLambdasOnAdapters) {
+    int limit = 2;
+    Stack<int> stack;
+    Queue<int> queue;
+    Deque<int> deque;
+    PriorityQueue<int> priorityQueue;
+    for (int i = 0; i < 5; ++i) {
+        stack.Push(i);
+        queue.Enqueue(i);
+        deque.PushBack(i);
+        priorityQueue.Enqueue(i, i);
+    }
+    Sequence<std::string>* names = stack.Map([](const int& x) { return std::to_string(x); });
+    EXPECT_EQ(names->GetLast(), "4");
+    delete names;
+
+    auto above = [&](const int& x) { return x > limit; };
+    Sequence<int>* fromQueue = queue.Where(above);
+    Sequence<int>* fromDeque = deque.Where(above);
+    Sequence<int>* fromPriorityQueue = priorityQueue.Where(above);
+    EXPECT_EQ(fromQueue->GetLength(), 2);
+    EXPECT_EQ(fromDeque->GetFirst(), 3);
+    EXPECT_EQ(fromPriorityQueue->GetFirst(), 3);
+    delete fromQueue;
+    delete fromDeque;
+    delete fromPriorityQueue;
+
+    auto add = [](const int& a, const int& b) { return a + b; };
+    EXPECT_EQ(stack.Reduce(add, limit), 12);
+    EXPECT_EQ(queue.Reduce(add, 0), 10);
+    EXPECT_EQ(priorityQueue.Reduce(add, 0), 10);
+    auto [big, small] = deque.Split(above);
+    EXPECT_EQ(small->GetSize(), 3);
+    EXPECT_EQ(big->GetSize(), 2);
+    delete small;
+    delete big;
+}
+
+// Тесты для Map со сменой типа элементов
+TEST(TypedMapTest, ProjectPeopleOnEverySequence) {
+    time_t now = time(nullptr);
+    Person people[4];
+    for (int i = 0; i < 4; ++i) {
+        people[i] = Person(PersonID{1, 10 + i}, "Ann", "", "Lee", now);
+    }
+    auto number = [](const Person& person) { return person.GetID().number; };
+    auto check = [](Sequence<int>* numbers) {
+        ASSERT_EQ(numbers->GetLength(), 4);
+        EXPECT_EQ(numbers->GetFirst(), 10);
+        EXPECT_EQ(numbers->GetLast(), 13);
+        delete numbers;
+    };
+    ArraySequence<Person> array(people, 4);
+    ListSequence<Person> list(people, 4);
+    ListSequence<Person, std::allocator<Person>, UnrolledLinkedList> unrolled(people, 4);
+    ImmutableArraySequence<Person> immutableArray(people, 4);
+    ImmutableListSequence<Person> immutableList(people, 4);
+    GapBufferSequence<Person> gapBuffer(people, 4);
+    RopeSequence<Person> rope(people, 4);
+    BTreeSequence<Person> tree(people, 4);
+    SegmentedArraySequence<Person> segmented(people, 4);
+    check(array.Map(number));
+    check(list.Map(number));
+    check(unrolled.Map(number));
+    check(immutableList.Map(number));
+    check(gapBuffer.Map(number));
+    check(rope.Map(number));
+    check(tree.Map(number));
+    check(segmented.Map(number));
+
+    Sequence<int>* frozen = immutableArray.Map(number);
+    EXPECT_NE(dynamic_cast<ImmutableArraySequence<int>*>(frozen), nullptr);
+    check(frozen);
+
+    // явный тип результата конвертирует значение func
+    Sequence<long long>* wide = array.Map<long long>(number);
+    EXPECT_EQ(wide->GetLast(), 13LL);
+    delete wide;
+    Sequence<std::string>* names = list.Map([](const Person& person) { return person.GetFullName(); });
+    EXPECT_EQ(names->GetFirst(), "Ann Lee");
+    delete names;
+}
+
+TEST(TypedMapTest, AdaptersAndSingleAllocation) {
+    Queue<int> queue;
+    Deque<int> deque;
+    PriorityQueue<int> priorityQueue;
+    for (int i = 0; i < 3; ++i) {
+        queue.Enqueue(i);
+        deque.PushFront(i);
+        priorityQueue.Enqueue(i, i);
+    }
+    auto half = [](const int& x) { return x / 2.0; };
+    Sequence<double>* fromQueue = queue.Map(half);
+    Sequence<double>* fromDeque = deque.Map(half);
+    Sequence<double>* fromPriorityQueue = priorityQueue.Map(half);
+    EXPECT_DOUBLE_EQ(fromQueue->GetLast(), 1.0);
+    EXPECT_DOUBLE_EQ(fromDeque->GetFirst(), 1.0);
+    EXPECT_DOUBLE_EQ(fromPriorityQueue->GetFirst(), 1.0);
+    delete fromQueue;
+    delete fromDeque;
+    delete fromPriorityQueue;
+
+    // массив под результат Map выделяется одним блоком, узлы списка -
+    // растущими блоками слаба (16, 32, ... - шесть блоков на 1000 узлов)
+    AllocationStats stats;
+    CountingAllocator<int> allocator(&stats);
+    ArraySequence<int, CountingAllocator<int>> array(allocator);
+    ListSequence<int, CountingAllocator<int>> list(allocator);
+    for (int i = 0; i < 1000; ++i) {
+        array.Append(i);
+        list.Append(i);
+    }
+    int before = stats.allocations;
+    Sequence<long long>* fromArray = array.Map([](const int& x) { return 2LL * x; });
+    EXPECT_EQ(stats.allocations, before + 1);
+    before = stats.allocations;
+    Sequence<long long>* fromList = list.Map([](const int& x) { return 2LL * x; });
+    EXPECT_EQ(stats.allocations, before + 6);
+    EXPECT_EQ(fromList->Get(999), 1998LL);
+    delete fromArray;
+    delete fromList;
+}
+
+// Тесты для ленивых запросов
+TEST(QueryTest, StagesMatchEagerResults) {
+    ArraySequence<int> numbers;
+    for (int i = 0; i < 10; ++i) {
+        numbers.Append(i);
+    }
+    ListSequence<int> tail;
+    tail.Append(100);
+    tail.Append(200);
+
+    ArraySequence<int> evens = From(numbers).Where(isEven).Map([](const int& x) { return x * 3; }).ToArraySequence();
+    ASSERT_EQ(evens.GetLength(), 5);
+    EXPECT_EQ(evens.Get(4), 24);
+
+    ListSequence<int> window = From(numbers).Skip(2).Take(3).Concat(From(tail)).ToListSequence();
+    ASSERT_EQ(window.GetLength(), 5);
+    EXPECT_EQ(window.Get(0), 2);
+    EXPECT_EQ(window.Get(2), 4);
+    EXPECT_EQ(window.Get(4), 200);
+
+    EXPECT_EQ(From(numbers).TakeWhile([](const int& x) { return x < 4; }).Count(), 4);
+    EXPECT_EQ(From(numbers).Skip(20).Count(), 0);
+    EXPECT_EQ(From(numbers).Reduce(sum, 0), numbers.Reduce(sum, 0));
+
+    // Zip заканчивается вместе с более коротким источником, тип элементов может меняться
+    auto pairs = From(numbers).Zip(From(tail)).ToArraySequence();
+    ASSERT_EQ(pairs.GetLength(), 2);
+    EXPECT_EQ(pairs.Get(1), std::make_pair(1, 200));
+    auto labels = From(numbers).Zip(From(tail), [](const int& x, const int& y) {
+        return std::to_string(x) + ":" + std::to_string(y);
+    }).ToListSequence();
+    EXPECT_EQ(labels.GetLast(), "1:200");
+}
+
+TEST(QueryTest, DeferredAndSinglePass) {
+    Queue<int> queue;
+    for (int i = 1; i <= 1000; ++i) {
+        queue.Enqueue(i);
+    }
+    int calls = 0;
+    auto query = From(queue).Map([&calls](const int& x) {
+        ++calls;
+        return x * x;
+    }).Where(isEven).Take(3);
+    // до материализации ничего не вычисляется
+    EXPECT_EQ(calls, 0);
+
+    // Take останавливает проход, как только набрано три элемента
+    ArraySequence<int> squares = query.ToArraySequence();
+    ASSERT_EQ(squares.GetLength(), 3);
+    EXPECT_EQ(squares.Get(0), 4);
+    EXPECT_EQ(squares.Get(2), 36);
+    EXPECT_EQ(calls, 6);
+
+    // запрос можно выполнить повторно, и он увидит новые данные источника
+    queue.Dequeue();
+    EXPECT_EQ(query.Reduce(sum, 0), 4 + 16 + 36);
+    queue.Dequeue();
+    EXPECT_EQ(query.Reduce(sum, 0), 16 + 36 + 64);
+    EXPECT_EQ(calls, 6 + 5 + 6);
+}
+
+// Тесты для параллельных HOF
+TEST(ParallelHofTest, MatchesSequentialResults) {
+    ArraySequence<int> sequence;
+    DynamicArray<int> values;
+    for (int i = 0; i < 100003; ++i) {
+        sequence.Append(i % 1000);
+        values.PushBack(i % 1000);
+    }
+    Vector<int> vector(std::move(values));
+    auto triple = [](const int& x) { return 3LL * x; };
+    // мелкие куски, чтобы границы кусков попадали в середину данных
+    for (IndexType chunkSize : {IndexType(1), IndexType(777), ParallelChunkSize}) {
+        Sequence<long long>* mapped = sequence.ParallelMap(triple, chunkSize);
+        Sequence<long long>* expectedMapped = sequence.Map(triple);
+        Sequence<int>* filtered = sequence.ParallelWhere(isEven, chunkSize);
+        Sequence<int>* expectedFiltered = sequence.Where(isEven);
+        ASSERT_EQ(mapped->GetLength(), expectedMapped->GetLength());
+        ASSERT_EQ(filtered->GetLength(), expectedFiltered->GetLength());
+        for (IndexType i = 0; i < mapped->GetLength(); i += 97) {
+            EXPECT_EQ(mapped->Get(i), expectedMapped->Get(i));
+        }
+        for (IndexType i = 0; i < filtered->GetLength(); i += 97) {
+            EXPECT_EQ(filtered->Get(i), expectedFiltered->Get(i));
+        }
+        delete mapped;
+        delete expectedMapped;
+        delete filtered;
+        delete expectedFiltered;
+
+        Vector<long long> vectorMapped = vector.ParallelMap(triple, chunkSize);
+        EXPECT_EQ(vectorMapped.Get(100002), 3LL * 2);
+        EXPECT_EQ(vector.ParallelWhere(isEven, chunkSize).GetSize(), 50002);
+        EXPECT_EQ(sequence.ParallelReduce(sum, 5, chunkSize), sequence.Reduce(sum, 5));
+        EXPECT_EQ(vector.ParallelReduce(sum, 5, chunkSize), sequence.Reduce(sum, 5));
+    }
+
+    // ассоциативная, но не коммутативная операция: порядок кусков сохраняется
+    ArraySequence<std::string> words;
+    for (int i = 0; i < 5000; ++i) {
+        words.Append(std::string(1, char('a' + i % 26)));
+    }
+    auto concat = [](const std::string& left, const std::string& right) { return left + right; };
+    EXPECT_EQ(words.ParallelReduce(concat, std::string(">"), 64), words.Reduce(concat, std::string(">")));
+
+    ArraySequence<int> empty;
+    EXPECT_EQ(empty.ParallelReduce(sum, 7), 7);
+    EXPECT_FALSE(empty.ParallelFind(isEven).isSome());
+    EXPECT_THROW(sequence.ParallelReduce(sum, 0, 0), InvalidArgumentException);
+}
+
+TEST(ParallelHofTest, BuildsElementsInPlace) {
+    NoDefault::alive = 0;
+    {
+        ArraySequence<int> sequence;
+        for (int i = 0; i < 10000; ++i) {
+            sequence.Append(i);
+        }
+        auto wrap = [](const int& x) { return NoDefault(x); };
+        Sequence<NoDefault>* wrapped = sequence.ParallelMap(wrap, 333);
+        EXPECT_EQ(NoDefault::alive, 10000);
+        EXPECT_EQ(wrapped->Get(9999).value, 9999);
+
+        auto* source = static_cast<ArraySequence<NoDefault>*>(wrapped);
+        Sequence<NoDefault>* odd = source->ParallelWhere([](const NoDefault& x) { return x.value % 2 == 1; }, 333);
+        EXPECT_EQ(odd->GetLength(), 5000);
+        EXPECT_EQ(odd->Get(2).value, 5);
+        EXPECT_EQ(NoDefault::alive, 15000);
+        delete odd;
+        delete wrapped;
+
+        Vector<NoDefault> vector = Vector<int>(DynamicArray<int>(sequence.Data(), 100)).ParallelMap(wrap, 7);
+        EXPECT_EQ(vector.Get(99).value, 99);
+
+        // исключение в середине: уже построенное разрушается, ничего не утекает
+        EXPECT_THROW(sequence.ParallelMap([](const int& x) {
+            if (x == 6543) {
+                throw InvalidStateException("boom");
+            }
+            return NoDefault(x);
+        }, 333), InvalidStateException);
+        EXPECT_EQ(NoDefault::alive, 100);
+    }
+    EXPECT_EQ(NoDefault::alive, 0);
+}
+
+TEST(ParallelHofTest, FindReturnsFirstMatchAndStopsEarly) {
+    ArraySequence<int> sequence;
+    for (int i = 0; i < 1000000; ++i) {
+        sequence.Append(i);
+    }
+    Vector<int> vector(DynamicArray<int>(sequence.Data(), sequence.GetLength()));
+
+    // подходят все элементы с 300000, ответ - самый левый из них
+    auto late = [](const int& x) { return x >= 300000 && x % 7 == 3; };
+    Option<int> found = sequence.ParallelFind(late, 1000);
+    ASSERT_TRUE(found.isSome());
+    EXPECT_EQ(found.getValue(), 300002);
+    EXPECT_EQ(vector.ParallelFind(late, 1000).getValue(), 300002);
+    EXPECT_FALSE(sequence.ParallelFind([](const int& x) { return x < 0; }, 1000).isSome());
+
+    // совпадение в начале: куски правее найденного не просматриваются
+    std::atomic<long long> calls(0);
+    Option<int> early = sequence.ParallelFind([&calls](const int& x) {
+        ++calls;
+        return x == 10;
+    }, 1000);
+    EXPECT_EQ(early.getValue(), 10);
+    EXPECT_LT(calls.load(), 1000000);
+
+    // исключение из predicate выходит из ParallelFind
+    EXPECT_THROW(sequence.ParallelFind([](const int& x) -> bool {
+        if (x == 123456) {
+            throw InvalidStateException("boom");
+        }
+        return false;
+    }, 1000), InvalidStateException);
+}